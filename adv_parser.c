@@ -0,0 +1,78 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "adv_parser.h"
+
+/**@brief Bluetooth base UUID, 0000xxxx-0000-1000-8000-00805F9B34FB, little endian. */
+static const uint8_t m_base_uuid[16] = {
+    0xFB, 0x34, 0x9B, 0x5F, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+bool adv_field_next(const uint8_t * p_adv, uint16_t adv_len, uint16_t * p_offset, adv_field_t * p_field)
+{
+    uint16_t offset = *p_offset;
+    if (p_adv == NULL || offset >= adv_len) {
+        return false;
+    }
+    // The length byte counts the type byte, but not itself
+    uint8_t field_length = p_adv[offset];
+    if (field_length == 0 || field_length > adv_len - offset - 1) {
+        return false;
+    }
+    p_field->type = p_adv[offset + 1];
+    p_field->len = field_length - 1;
+    p_field->p_data = &p_adv[offset + 2];
+    *p_offset = offset + 1 + field_length;
+    return true;
+}
+
+bool adv_field_has_uuid16(const adv_field_t * p_field, uint16_t uuid)
+{
+    uint8_t stride;
+    switch (p_field->type) {
+        case ADV_TYPE_UUID16_MORE:
+        case ADV_TYPE_UUID16_COMPLETE:
+            stride = 2;
+            break;
+        case ADV_TYPE_UUID32_MORE:
+        case ADV_TYPE_UUID32_COMPLETE:
+            stride = 4;
+            break;
+        case ADV_TYPE_UUID128_MORE:
+        case ADV_TYPE_UUID128_COMPLETE:
+            stride = 16;
+            break;
+        default:
+            return false;
+    }
+
+    for (uint8_t i = 0; i + stride <= p_field->len; i += stride) {
+        const uint8_t * p_uuid = &p_field->p_data[i];
+        if (stride == 16) {
+            // Bytes 12 and 13 carry the 16 bit UUID; everything else must be the base
+            if (memcmp(p_uuid, m_base_uuid, 12) != 0 || memcmp(&p_uuid[14], &m_base_uuid[14], 2) != 0) {
+                continue;
+            }
+            p_uuid += 12;
+        }
+        if ((uint16_t)(p_uuid[0] | (p_uuid[1] << 8)) == uuid) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,69 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef ADV_PARSER_H
+#define ADV_PARSER_H
+
+/**@file
+ *
+ * @brief    Bounds-checked walk over the AD structures of an advertising report.
+ *
+ * @details  Advertising data is a list of length | type | data fields, all of it from the air.
+ *           A field that claims more bytes than the report holds ends the walk, as does a zero
+ *           length (the start of the unused part of the packet), so no field is ever read past
+ *           the report.
+ *
+ *           Service UUIDs are matched as the SoftDevice decodes them: a 16 bit UUID, the low
+ *           16 bits of a 32 bit one, or a 128 bit UUID on the Bluetooth base UUID.
+ *
+ * @note     This module has no SDK dependencies; the Linux tools in host/ build the same source.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ADV_TYPE_FLAGS                  0x01
+#define ADV_TYPE_UUID16_MORE            0x02
+#define ADV_TYPE_UUID16_COMPLETE        0x03
+#define ADV_TYPE_UUID32_MORE            0x04
+#define ADV_TYPE_UUID32_COMPLETE        0x05
+#define ADV_TYPE_UUID128_MORE           0x06
+#define ADV_TYPE_UUID128_COMPLETE       0x07
+#define ADV_TYPE_SHORT_LOCAL_NAME       0x08
+#define ADV_TYPE_COMPLETE_LOCAL_NAME    0x09
+
+/**@brief One AD structure; p_data points into the report. */
+typedef struct
+{
+    uint8_t             type;
+    uint8_t             len;
+    const uint8_t       *p_data;
+} adv_field_t;
+
+/**@brief   Read the field at *p_offset and advance past it.
+ *
+ * @param[in]     p_adv     Advertising data
+ * @param[in]     adv_len   Length of p_adv
+ * @param[in,out] p_offset  Start at 0
+ * @param[out]    p_field   Field read
+ *
+ * @retval  false when there are no more whole fields.
+ */
+bool adv_field_next(const uint8_t * p_adv, uint16_t adv_len, uint16_t * p_offset, adv_field_t * p_field);
+
+/**@brief   True if the field is a service UUID list that contains uuid. */
+bool adv_field_has_uuid16(const adv_field_t * p_field, uint16_t uuid);
+
+#endif // ADV_PARSER_H
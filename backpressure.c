@@ -0,0 +1,66 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "backpressure.h"
+
+void backpressure_init(backpressure_t * p_backpressure)
+{
+    p_backpressure->level = 0;
+    p_backpressure->congested = 0;
+    p_backpressure->clear = 0;
+}
+
+backpressure_action_t backpressure_check(backpressure_t * p_backpressure, uint8_t peak, bool dropped)
+{
+    if (dropped || peak >= BACKPRESSURE_HIGH_PERCENT) {
+        p_backpressure->clear = 0;
+        if (p_backpressure->level < BACKPRESSURE_MAX_LEVEL &&
+            ++p_backpressure->congested >= BACKPRESSURE_SLOW_CHECKS)
+        {
+            p_backpressure->congested = 0;
+            ++p_backpressure->level;
+            return BACKPRESSURE_SLOW_DOWN;
+        }
+    }
+    else if (peak <= BACKPRESSURE_LOW_PERCENT) {
+        p_backpressure->congested = 0;
+        if (p_backpressure->level > 0 &&
+            ++p_backpressure->clear >= BACKPRESSURE_RESTORE_CHECKS)
+        {
+            p_backpressure->clear = 0;
+            --p_backpressure->level;
+            return BACKPRESSURE_RESTORE;
+        }
+    }
+    else {
+        p_backpressure->congested = 0;
+        p_backpressure->clear = 0;
+    }
+    return BACKPRESSURE_HOLD;
+}
+
+uint8_t backpressure_level(const backpressure_t * p_backpressure)
+{
+    return p_backpressure->level;
+}
+
+uint32_t backpressure_period(const backpressure_t * p_backpressure, uint32_t period, uint32_t max_period)
+{
+    period <<= p_backpressure->level;
+    return (period < max_period) ? period : max_period;
+}
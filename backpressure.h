@@ -0,0 +1,88 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef BACKPRESSURE_H
+#define BACKPRESSURE_H
+
+/**@file
+ *
+ * @brief    Slows the SensorTag's sampling down while the output cannot keep up.
+ *
+ * @details  The caller checks the output queue at a fixed interval and passes its peak fill
+ *           since the previous check. After BACKPRESSURE_SLOW_CHECKS congested checks in a row
+ *           (peak at or above BACKPRESSURE_HIGH_PERCENT, or bytes dropped) the level goes up by
+ *           one, and the caller stretches every sampling period by 2^level. After
+ *           BACKPRESSURE_RESTORE_CHECKS clear checks in a row (peak at or below
+ *           BACKPRESSURE_LOW_PERCENT) the level comes down by one. A check in between resets
+ *           both counts.
+ *
+ *           Both counts also restart on every change, so the new periods have time to show in
+ *           the queue before the next step. Slowing down is quick and restoring is slow, which
+ *           keeps the level near the highest rate the output sustains instead of oscillating
+ *           around it.
+ *
+ * @note     This module has no SDK dependencies.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BACKPRESSURE_HIGH_PERCENT       50                      /**< Peak fill that counts as congested. */
+#define BACKPRESSURE_LOW_PERCENT        10                      /**< Peak fill that counts as clear. */
+#define BACKPRESSURE_SLOW_CHECKS        4                       /**< Congested checks in a row before a level up. */
+#define BACKPRESSURE_RESTORE_CHECKS     60                      /**< Clear checks in a row before a level down. */
+#define BACKPRESSURE_MAX_LEVEL          3                       /**< Periods are stretched at most 2^3 times. */
+
+/**@brief Action the caller should take after a check. */
+typedef enum
+{
+    BACKPRESSURE_HOLD,
+    BACKPRESSURE_SLOW_DOWN,
+    BACKPRESSURE_RESTORE,
+} backpressure_action_t;
+
+typedef struct
+{
+    uint8_t             level;
+    uint8_t             congested;                              // Congested checks in a row
+    uint8_t             clear;                                  // Clear checks in a row
+} backpressure_t;
+
+
+/**@brief   Reset to level 0. */
+void backpressure_init(backpressure_t * p_backpressure);
+
+/**@brief   Account for one check.
+ *
+ * @param[in] p_backpressure Controller
+ * @param[in] peak           Highest queue fill since the previous check, in percent
+ * @param[in] dropped        Output was dropped since the previous check
+ *
+ * @return  BACKPRESSURE_SLOW_DOWN or BACKPRESSURE_RESTORE when the level has changed.
+ */
+backpressure_action_t backpressure_check(backpressure_t * p_backpressure, uint8_t peak, bool dropped);
+
+/**@brief   Current level: sampling periods are stretched by 2^level. */
+uint8_t backpressure_level(const backpressure_t * p_backpressure);
+
+/**@brief   A period stretched by the current level.
+ *
+ * @param[in] p_backpressure Controller
+ * @param[in] period         Period as configured, in any unit
+ * @param[in] max_period     Longest period the caller can set, in the same unit
+ */
+uint32_t backpressure_period(const backpressure_t * p_backpressure, uint32_t period, uint32_t max_period);
+
+#endif // BACKPRESSURE_H
@@ -19,6 +19,8 @@
 #include <assert.h>
 
 #include "ble_sensortag_client.h"
+#include "log_support.h"
+#include "sensortag_payload.h"
 
 #include "ble_gattc.h"
 #include "sdk_macros.h"
@@ -70,7 +72,7 @@ uint32_t st_clientheck_service(st_client_t *p_client, st_client_svc_t* p_service
     if (p_client->conn_handle == BLE_CONN_HANDLE_INVALID)
         return NRF_ERROR_INVALID_STATE;
    
-    for (int i = 0; i < sizeof(p_service->handles) / sizeof(p_service->handles[0]); ++i) {
+    for (size_t i = 0; i < sizeof(p_service->handles) / sizeof(p_service->handles[0]); ++i) {
         if (p_service->handles[i] == BLE_CONN_HANDLE_INVALID) {
             return NRF_ERROR_INVALID_STATE;
         }
@@ -98,6 +100,7 @@ uint32_t st_client_init(st_client_t * p_client, st_client_init_t * p_client_init
 
     p_client->conn_handle = BLE_CONN_HANDLE_INVALID;
     p_client->evt_handler = p_client_init->evt_handler;
+    p_client->timestamp_source = p_client_init->timestamp_source;
     
     const uint8_t total_services = sizeof(p_client->services) / sizeof(st_client_svc_t);
     static_assert(total_services == sizeof(default_services) / sizeof(st_client_svc_t*));
@@ -111,7 +114,7 @@ uint32_t st_client_init(st_client_t * p_client, st_client_init_t * p_client_init
         st_service_uuid.type = p_client->uuid_type;
         err_code = ble_db_discovery_evt_register(&st_service_uuid);
     }
-    printf("initialization complete: code %lx\n", err_code);
+    LOG("initialization complete: code %lx", (unsigned long)err_code);
 
     return err_code;
 }
@@ -128,7 +131,7 @@ void st_client_on_db_disc_evt(st_client_t *p_client, ble_db_discovery_evt_t * p_
 
     case BLE_DB_DISCOVERY_COMPLETE:
         uint16_t service_uuid = p_evt->params.discovered_db.srv_uuid.uuid;
-        printf("[GATT] Service discovered: %x\n", service_uuid);
+        LOG("[GATT] Service discovered: %x", service_uuid);
         if (p_evt->params.discovered_db.srv_uuid.type != p_client->uuid_type) {
             return;
         }
@@ -162,7 +165,7 @@ void st_client_on_db_disc_evt(st_client_t *p_client, ble_db_discovery_evt_t * p_
                 service->handles[PERI] = p_chars[i].characteristic.handle_value;
                 break;
             default:
-                printf("[GATT] Service %x discarded characteristic %x", service_uuid, chrc_uuid);
+                LOG("[GATT] Service %x discarded characteristic %x", service_uuid, chrc_uuid);
                 break;
             }
         }
@@ -175,10 +178,11 @@ void st_client_on_db_disc_evt(st_client_t *p_client, ble_db_discovery_evt_t * p_
         }
         break;
     case BLE_DB_DISCOVERY_SRV_NOT_FOUND:
-        printf("Could not find the service!\n");
+        LOG("Could not find the service!");
         break;
     case BLE_DB_DISCOVERY_AVAILABLE:
-        printf("Discovery available\n");
+        LOG("Discovery available");
+        break;
     default:
         break;
     }
@@ -197,6 +201,9 @@ void st_client_on_db_disc_evt(st_client_t *p_client, ble_db_discovery_evt_t * p_
 */
 static void on_hvx(st_client_t *p_client, const ble_evt_t *p_ble_evt)
 {
+    // Stamp before anything else, so the time is as close to reception as possible
+    uint64_t timestamp = p_client->timestamp_source ? p_client->timestamp_source() : 0;
+
     // Confirm and select relevant service 
     uint16_t hvx_handle = p_ble_evt->evt.gattc_evt.params.hvx.handle;
     st_client_svc_t* service = p_client->services;
@@ -210,7 +217,9 @@ static void on_hvx(st_client_t *p_client, const ble_evt_t *p_ble_evt)
     st_client_evt_t hvx_data_event  = {
         .evt_type = service->events.data_ready,
         .p_data   = (uint8_t *)p_ble_evt->evt.gattc_evt.params.hvx.data,
-        .data_len = p_ble_evt->evt.gattc_evt.params.hvx.len
+        .data_len = p_ble_evt->evt.gattc_evt.params.hvx.len,
+        .timestamp = timestamp,
+        .seq      = service->seq++
     };
     p_client->evt_handler(p_client, &hvx_data_event);
 }
@@ -284,6 +293,26 @@ uint32_t st_client_conf_enable(st_client_t *p_client, uint16_t service_uuid, boo
     return sd_ble_gattc_write(p_client->conn_handle, &write_params);
 }
 
+uint32_t st_client_period_set(st_client_t *p_client, uint16_t service_uuid, uint8_t period)
+{
+    st_client_svc_t* service = st_client_get_service(p_client, service_uuid);
+    VERIFY_SUCCESS(st_clientheck_service(p_client, service));
+    
+    uint8_t buf[PERI_CHRC_MSG_LEN];
+    buf[0] = period;
+   
+    const ble_gattc_write_params_t write_params = {
+        .write_op = BLE_GATT_OP_WRITE_CMD,
+        .flags    = BLE_GATT_EXEC_WRITE_FLAG_PREPARED_WRITE,
+        .handle   = service->handles[PERI],
+        .offset   = 0,
+        .len      = sizeof(buf),
+        .p_value  = buf
+    };
+    
+    return sd_ble_gattc_write(p_client->conn_handle, &write_params);
+}
+
 uint32_t service_enable(st_client_t *p_client, uint16_t service_uuid, bool enable) 
 {
     VERIFY_SUCCESS(st_client_data_notify(p_client, service_uuid, enable));
@@ -294,14 +323,19 @@ uint32_t service_enable(st_client_t *p_client, uint16_t service_uuid, bool enabl
 
 // User helper functions to decode the ST data packets
 
+static_assert(ST_CLIENT_MAX_RAW_VALUES >= STREAM_MAX_VALUES, "raw[] must hold every payload value");
+
 st_client_data_t extract_luxometer_data(const st_client_evt_t * p_st_c_evt)
 {
     st_client_data_t value = { .valid = false}; 
     if (p_st_c_evt && 
         p_st_c_evt->evt_type == ST_CLIENT_EVT_LUXO_DATA && 
-        (p_st_c_evt->data_len > 1)) 
+        st_payload_decode(STREAM_LUXO, p_st_c_evt->p_data, p_st_c_evt->data_len, value.raw)) 
     {
-        value.luxo_data = *(uint16_t*)p_st_c_evt->p_data;
+        value.luxo_data = (uint16_t)value.raw[0];
+        value.raw_count = st_payload_def(STREAM_LUXO)->value_count;
+        value.timestamp = p_st_c_evt->timestamp;
+        value.seq = p_st_c_evt->seq;
         value.valid = true;
     }
     return value;
@@ -312,15 +346,14 @@ st_client_data_t extract_temperature_data(const st_client_evt_t * p_st_c_evt)
     st_client_data_t value = { .valid = false}; 
     if (p_st_c_evt && 
         p_st_c_evt->evt_type == ST_CLIENT_EVT_TEMP_DATA &&
-        p_st_c_evt->data_len == 4) 
+        st_payload_decode(STREAM_TEMP, p_st_c_evt->p_data, p_st_c_evt->data_len, value.raw)) 
     {
-        uint8_t *source = p_st_c_evt->p_data; 
-        // four-bytes data field, made up of two SIGNED 16 bit ints.
-        // The scaling factor 'ECG patch' is 0.0078125.
-        int16_t ir    = *(int16_t*)(&source[0]);
-        int16_t amb   = *(int16_t*)(&source[2]);
-        value.temp_data.ir_data = 0.0078125 * ir;
-        value.temp_data.amb_data= 0.0078125 * amb;
+        // IR and ambient words, scaled as defined in sensortag_payload.c
+        value.temp_data.ir_data = st_payload_scale(STREAM_TEMP, value.raw[0]);
+        value.temp_data.amb_data= st_payload_scale(STREAM_TEMP, value.raw[1]);
+        value.raw_count = st_payload_def(STREAM_TEMP)->value_count;
+        value.timestamp = p_st_c_evt->timestamp;
+        value.seq = p_st_c_evt->seq;
         value.valid = true;
     }
     return value;
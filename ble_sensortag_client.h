@@ -48,6 +48,9 @@
 #define BLE_UUID_ST_TEMP_SERVICE        0xaa00
 
 #define CONF_CHRC_MSG_LEN        1 
+#define PERI_CHRC_MSG_LEN        1
+#define ST_CLIENT_PERIOD_UNIT_MS 10                                 /**< Resolution of the PERIod characteristic. */
+#define ST_CLIENT_MAX_RAW_VALUES 2                                  /**< Most sensor words carried by one DATA notification. */
 
 /* Most of the SensorTag services have three characteristics: DATA, CONFiguration, PERIod */
 typedef enum {
@@ -74,6 +77,10 @@ typedef enum
 typedef struct 
 {
     bool                valid;
+    uint64_t            timestamp;                              // RTC ticks when the notification was received
+    uint16_t            seq;                                    // Sequence number of the notification in its service
+    uint8_t             raw_count;                              // Number of undecoded sensor words in raw
+    int32_t             raw[ST_CLIENT_MAX_RAW_VALUES];          // Sensor words as sent by the tag, before scaling
     union
     {
         uint16_t        luxo_data;
@@ -90,7 +97,9 @@ typedef struct {
     st_client_evt_type_t evt_type;
     uint16_t            conn_handle;
     uint8_t             *p_data;
-    uint8_t             data_len;
+    uint16_t            data_len;
+    uint64_t            timestamp;                              // Data events: receive time from the timestamp source
+    uint16_t            seq;                                    // Data events: notifications of the service so far, wrapping
 } st_client_evt_t;
 
 
@@ -120,6 +129,7 @@ typedef struct {
     uint8_t             name[5];
     uint16_t            handles[4];
     st_client_svc_evts_t events;
+    uint16_t            seq;                                    // Sequence number of the next notification, kept across links
 } st_client_svc_t;
 
 
@@ -132,6 +142,12 @@ typedef struct st_client_s st_client_t;
  */
 typedef void (* st_client_evt_handler_t)(st_client_t * p_st_client, const st_client_evt_t * p_evt);
 
+/**@brief   Timestamp source used to stamp data events as they are received
+ *
+ * @details Returns a free-running tick count; the units are the application's choice.
+ */
+typedef uint64_t (* st_client_timestamp_source_t)(void);
+
 
 
 /**@brief BLE SensorTag Client structure.
@@ -142,6 +158,7 @@ struct st_client_s
     uint8_t                 uuid_type;         
     uint8_t                 service_count;    
     st_client_evt_handler_t  evt_handler;     
+    st_client_timestamp_source_t timestamp_source;
     st_client_svc_t          services[2];    
 };
 
@@ -157,6 +174,7 @@ uint32_t st_client_add_vs_base_uuid(st_client_t * p_st_client);
  */
 typedef struct {
     st_client_evt_handler_t  evt_handler;
+    st_client_timestamp_source_t timestamp_source;              // Optional; data events are stamped 0 without one
 } st_client_init_t;
 
 
@@ -244,6 +262,21 @@ uint32_t st_client_data_notify(st_client_t *p_st_client, uint16_t service_uuid,
  */
 uint32_t st_client_conf_enable(st_client_t *p_st_client, uint16_t service_uuid, bool enable);
 
+/**@brief   Function for requesting the peer to change the sampling period of the SERVICE.
+ *
+ * @details This function direct writes into the PERI chrc. The SensorTag clamps the period to
+ *          each sensor's own minimum.
+ *
+ * @param   p_st_client      Pointer to the SensorTag client structure.
+ * @param   service_uuid    UUID short code of the service (not the characteristic)
+ * @param   period          Period in units of ST_CLIENT_PERIOD_UNIT_MS
+ *
+ * @retval  NRF_SUCCESS If the SoftDevice has been requested to write to the PERI chrc of the peer.
+ *                      Otherwise, an error code is returned. This function propagates the error  
+ *                      code returned by the SoftDevice API @ref sd_ble_gattc_write.
+ */
+uint32_t st_client_period_set(st_client_t *p_st_client, uint16_t service_uuid, uint8_t period);
+
 /**@brief   Helper function to switch on a service and enable notifications. Reports
  *          errors via printf.
  *
@@ -0,0 +1,100 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "command_support.h"
+
+#define COMMAND_WORD_CHARS      4
+
+static void command_clear(command_parser_t * p_parser)
+{
+    memset(&p_parser->command, 0, sizeof(p_parser->command));
+    p_parser->token_len = 0;
+    p_parser->malformed = false;
+}
+
+static void command_end_line(command_parser_t * p_parser)
+{
+    if (p_parser->malformed) {
+        p_parser->handler(p_parser->p_context, NULL);
+    }
+    else if (p_parser->command.count > 0) {
+        p_parser->handler(p_parser->p_context, &p_parser->command);
+    }
+    command_clear(p_parser);
+}
+
+static void command_token_char(command_parser_t * p_parser, uint8_t byte)
+{
+    if (p_parser->token_len == 0) {
+        if (p_parser->command.count == COMMAND_MAX_TOKENS) {
+            p_parser->malformed = true;
+            return;
+        }
+        command_token_t * p_new = &p_parser->command.tokens[p_parser->command.count++];
+        p_new->is_number = true;
+    }
+
+    command_token_t * p_token = &p_parser->command.tokens[p_parser->command.count - 1];
+    if (p_parser->token_len < COMMAND_WORD_CHARS) {
+        uint8_t lower = (byte >= 'A' && byte <= 'Z') ? byte - 'A' + 'a' : byte;
+        p_token->word |= (uint32_t)lower << (8 * p_parser->token_len);
+    }
+    if (p_parser->token_len < UINT8_MAX) {
+        ++p_parser->token_len;
+    }
+
+    if (byte < '0' || byte > '9') {
+        p_token->is_number = false;
+    }
+    else if (p_token->is_number) {
+        uint32_t digit = byte - '0';
+        p_token->number = (p_token->number > (UINT32_MAX - digit) / 10) ? UINT32_MAX
+                                                                       : p_token->number * 10 + digit;
+    }
+}
+
+void command_parser_init(command_parser_t * p_parser, command_handler_t handler, void * p_context)
+{
+    p_parser->handler = handler;
+    p_parser->p_context = p_context;
+    command_clear(p_parser);
+}
+
+void command_parser_put(command_parser_t * p_parser, uint8_t byte)
+{
+    switch (byte)
+    {
+        case '\r':
+        case '\n':
+            command_end_line(p_parser);
+            break;
+        case ' ':
+        case '\t':
+            p_parser->token_len = 0;
+            break;
+        default:
+            if (byte < ' ' || byte > '~') {
+                p_parser->malformed = true;
+            }
+            else if (!p_parser->malformed) {
+                command_token_char(p_parser, byte);
+            }
+            break;
+    }
+}
@@ -0,0 +1,85 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef COMMAND_SUPPORT_H
+#define COMMAND_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Incremental parser for the UART command line.
+ *
+ * @details  Commands are lines of up to COMMAND_MAX_TOKENS whitespace separated tokens, ended
+ *           by CR or LF. Bytes are fed in one at a time as they arrive; nothing is buffered.
+ *           Each token is reduced on the fly to its first four characters, lower cased and
+ *           packed into a word (compare with COMMAND_WORD), and, if it is all digits, to its
+ *           decimal value. "peri temp 1000" is therefore three tokens: two words and a number.
+ *
+ * @note     This module has no SDK dependencies.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define COMMAND_MAX_TOKENS      3                               /**< Verb and up to two arguments. */
+
+/**@brief Pack up to four characters as the parser does; pass 0 for unused characters. */
+#define COMMAND_WORD(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+/**@brief One token of a command line. */
+typedef struct
+{
+    uint32_t            word;                                   // First four characters, see COMMAND_WORD
+    uint32_t            number;                                 // Decimal value, saturated, if is_number
+    bool                is_number;
+} command_token_t;
+
+/**@brief A complete command line. */
+typedef struct
+{
+    command_token_t     tokens[COMMAND_MAX_TOKENS];
+    uint8_t             count;
+} command_t;
+
+/**@brief   Called at the end of every non-empty line.
+ *
+ * @param[in] p_context Context given to command_parser_init
+ * @param[in] p_command The command, or NULL if the line was malformed (too many tokens or
+ *                      a control character)
+ */
+typedef void (* command_handler_t)(void * p_context, const command_t * p_command);
+
+/**@brief Parser state. */
+typedef struct
+{
+    command_t           command;
+    uint8_t             token_len;                              // Characters seen in the current token, 0 between tokens
+    bool                malformed;
+    command_handler_t   handler;
+    void                *p_context;
+} command_parser_t;
+
+
+/**@brief   Initialize a parser.
+ *
+ * @param[in] p_parser  Parser
+ * @param[in] handler   Called for each line
+ * @param[in] p_context Passed to the handler
+ */
+void command_parser_init(command_parser_t * p_parser, command_handler_t handler, void * p_context);
+
+/**@brief   Feed one received byte to the parser. The handler runs from within this call. */
+void command_parser_put(command_parser_t * p_parser, uint8_t byte);
+
+#endif // COMMAND_SUPPORT_H
@@ -0,0 +1,176 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "error_support.h"
+#include "lifecycle_support.h"
+#include "log_support.h"
+#include "stats_support.h"
+
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util.h"
+#include "ble.h"
+
+/**@brief What a site does with a transient error, and once it has failed ERROR_RETRY_MAX times. */
+typedef enum
+{
+    RECOVERY_IGNORE,
+    RECOVERY_RETRY,
+    RECOVERY_ROLLBACK,
+    RECOVERY_RESET,
+} recovery_t;
+
+typedef struct
+{
+    stats_counter_t     counter;
+    recovery_t          transient;
+    recovery_t          exhausted;
+} site_policy_t;
+
+static const site_policy_t m_policies[ERROR_SITE_COUNT] = {
+    // Nothing works without scanning, so a scan that cannot be started is a fault after all
+    [ERROR_SITE_SCAN_START]        = { STATS_ERROR_SCAN_START,        RECOVERY_RETRY,    RECOVERY_RESET    },
+    // Scanning goes on, and the next advertising report tries again
+    [ERROR_SITE_CONNECT]           = { STATS_ERROR_CONNECT,           RECOVERY_ROLLBACK, RECOVERY_ROLLBACK },
+    [ERROR_SITE_DISCOVERY_START]   = { STATS_ERROR_DISCOVERY_START,   RECOVERY_RETRY,    RECOVERY_ROLLBACK },
+    [ERROR_SITE_SERVICE_CONFIGURE] = { STATS_ERROR_SERVICE_CONFIGURE, RECOVERY_RETRY,    RECOVERY_ROLLBACK },
+    [ERROR_SITE_DISCONNECT]        = { STATS_ERROR_DISCONNECT,        RECOVERY_RETRY,    RECOVERY_RESET    },
+    // Without a reply the peer's security procedure times out and drops the link
+    [ERROR_SITE_SEC_PARAMS_REPLY]  = { STATS_ERROR_SEC_PARAMS_REPLY,  RECOVERY_ROLLBACK, RECOVERY_ROLLBACK },
+    // The peer asks again, or keeps the current parameters
+    [ERROR_SITE_CONN_PARAM_UPDATE] = { STATS_ERROR_CONN_PARAM_UPDATE, RECOVERY_IGNORE,   RECOVERY_IGNORE   },
+    [ERROR_SITE_INDICATION]        = { STATS_ERROR_INDICATION,        RECOVERY_IGNORE,   RECOVERY_IGNORE   },
+    // The relay is optional: its failures never touch the SensorTag link
+    [ERROR_SITE_RELAY_ADV_START]   = { STATS_ERROR_RELAY_ADV_START,   RECOVERY_RETRY,    RECOVERY_IGNORE   },
+    [ERROR_SITE_RELAY_GATTS]       = { STATS_ERROR_RELAY_GATTS,       RECOVERY_IGNORE,   RECOVERY_IGNORE   },
+};
+
+APP_TIMER_DEF(m_retry_timer);
+
+static error_rollback_t m_rollback;
+static error_retry_t    m_retry[ERROR_SITE_COUNT];          // Pending retries, run by the timer
+static uint8_t          m_failures[ERROR_SITE_COUNT];       // Consecutive transient errors per site
+static bool             m_timer_running;
+
+
+static bool is_stale(uint32_t err_code)
+{
+    return err_code == NRF_ERROR_INVALID_STATE ||
+           err_code == BLE_ERROR_INVALID_CONN_HANDLE;
+}
+
+static bool is_transient(uint32_t err_code)
+{
+    switch (err_code)
+    {
+        case NRF_ERROR_BUSY:
+        case NRF_ERROR_NO_MEM:
+        case NRF_ERROR_TIMEOUT:
+        case NRF_ERROR_CONN_COUNT:
+        case BLE_ERROR_NO_TX_PACKETS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void retry_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    m_timer_running = false;
+
+    for (uint8_t site = 0; site < ERROR_SITE_COUNT; ++site) {
+        error_retry_t retry = m_retry[site];
+        m_retry[site] = NULL;
+        if (retry != NULL) {
+            retry();
+        }
+    }
+}
+
+static void retry_schedule(error_site_t site, error_retry_t retry)
+{
+    m_retry[site] = retry;
+    if (!m_timer_running) {
+        uint32_t err_code = app_timer_start(m_retry_timer,
+                                            APP_TIMER_TICKS(ERROR_RETRY_DELAY_MS, APP_TIMER_PRESCALER),
+                                            NULL);
+        APP_ERROR_CHECK(err_code);
+        m_timer_running = true;
+    }
+}
+
+void error_support_init(error_rollback_t rollback)
+{
+    m_rollback = rollback;
+
+    uint32_t err_code = app_timer_create(&m_retry_timer, APP_TIMER_MODE_SINGLE_SHOT, retry_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+}
+
+bool error_check(error_site_t site, uint32_t err_code, error_retry_t retry,
+                 uint32_t line_num, const uint8_t * p_file_name)
+{
+    const site_policy_t * p_policy = &m_policies[site];
+
+    if (err_code == NRF_SUCCESS) {
+        m_failures[site] = 0;
+        return true;
+    }
+    if (!is_stale(err_code) && !is_transient(err_code)) {
+        app_error_handler(err_code, line_num, p_file_name);
+        return false;
+    }
+
+    stats_increment(p_policy->counter);
+    stats_set(STATS_ERROR_LAST_CODE, err_code);
+    if (is_stale(err_code)) {
+        return false;
+    }
+
+    recovery_t recovery = p_policy->transient;
+    if (++m_failures[site] >= ERROR_RETRY_MAX) {
+        m_failures[site] = 0;
+        recovery = p_policy->exhausted;
+    }
+    if (recovery == RECOVERY_RETRY && retry == NULL) {
+        recovery = RECOVERY_ROLLBACK;
+    }
+    // The site by its error_site_t index: the token scheme carries no strings
+    LOG("[ERR] site %u: 0x%lx", site, (unsigned long)err_code);
+
+    switch (recovery)
+    {
+        case RECOVERY_RETRY:
+            stats_increment(STATS_ERROR_RETRIES);
+            retry_schedule(site, retry);
+            break;
+        case RECOVERY_ROLLBACK:
+            stats_increment(STATS_ERROR_ROLLBACKS);
+            if (m_rollback != NULL) {
+                m_rollback();
+            }
+            break;
+        case RECOVERY_RESET:
+            app_error_handler(err_code, line_num, p_file_name);
+            break;
+        case RECOVERY_IGNORE:
+            break;
+    }
+    return false;
+}
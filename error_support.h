@@ -0,0 +1,89 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef ERROR_SUPPORT_H
+#define ERROR_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Recovery from SoftDevice errors at run time.
+ *
+ * @details  APP_ERROR_CHECK resets the chip on any error, which throws away the link for a
+ *           condition that often clears by itself. ERROR_CHECK classifies the code instead:
+ *
+ *           - stale: NRF_ERROR_INVALID_STATE, BLE_ERROR_INVALID_CONN_HANDLE. The operation no
+ *             longer applies (the link is gone, scanning already runs); the event that changed
+ *             the state drives what happens next, so the error is only counted.
+ *           - transient: busy, out of buffers or links, timed out. The site's policy applies:
+ *             ignore it, retry the operation after ERROR_RETRY_DELAY_MS, or roll the link back
+ *             (disconnect, or scan again). A site that keeps failing is escalated.
+ *           - anything else is a fault and resets through app_error_handler as before.
+ *
+ *           Every recovered error is counted per site in stats_support.h, and the last code is
+ *           kept, so a remote `stat` shows where errors come from without a debugger.
+ *           Initialization still uses APP_ERROR_CHECK: an error during boot is a fault.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ERROR_RETRY_DELAY_MS    100                             /**< Delay before a failed operation is tried again. */
+#define ERROR_RETRY_MAX         5                               /**< Consecutive failures at one site before it escalates. */
+
+/**@brief Places that recover from errors; each has its own policy and counter. */
+typedef enum
+{
+    ERROR_SITE_SCAN_START,                  // sd_ble_gap_scan_start
+    ERROR_SITE_CONNECT,                     // sd_ble_gap_connect
+    ERROR_SITE_DISCOVERY_START,             // ble_db_discovery_start
+    ERROR_SITE_SERVICE_CONFIGURE,           // PERIod, CCCD and CONFiguration writes after discovery
+    ERROR_SITE_DISCONNECT,                  // sd_ble_gap_disconnect
+    ERROR_SITE_SEC_PARAMS_REPLY,            // sd_ble_gap_sec_params_reply
+    ERROR_SITE_CONN_PARAM_UPDATE,           // sd_ble_gap_conn_param_update
+    ERROR_SITE_INDICATION,                  // bsp_indication_set
+    ERROR_SITE_RELAY_ADV_START,             // sd_ble_gap_adv_start for the relay
+    ERROR_SITE_RELAY_GATTS,                 // Relay GATT server replies
+    ERROR_SITE_COUNT
+} error_site_t;
+
+/**@brief   Operation to run again after a transient error. */
+typedef void (* error_retry_t)(void);
+
+/**@brief   Drop the SensorTag link if there is one, otherwise start scanning. */
+typedef void (* error_rollback_t)(void);
+
+
+/**@brief   Check a return code, recovering or resetting as the site's policy says.
+ *
+ * @param[in] site      Error site
+ * @param[in] err_code  Return code to check
+ * @param[in] retry     Operation to retry for a transient error, NULL to roll back instead
+ *
+ * @retval  true if err_code is NRF_SUCCESS. Does not return on a fault.
+ */
+#define ERROR_CHECK(site, err_code, retry) \
+    error_check((site), (err_code), (retry), __LINE__, (const uint8_t *)__FILE__)
+
+/**@brief   Create the retry timer. Call after timer_init().
+ *
+ * @param[in] rollback  Called when a site's policy, or an escalation, rolls the link back
+ */
+void error_support_init(error_rollback_t rollback);
+
+/**@brief   See ERROR_CHECK. */
+bool error_check(error_site_t site, uint32_t err_code, error_retry_t retry,
+                 uint32_t line_num, const uint8_t * p_file_name);
+
+#endif // ERROR_SUPPORT_H
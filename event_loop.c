@@ -14,9 +14,25 @@
  */
 
 #include "event_loop.h"
+#include "backpressure.h"
+#include "command_support.h"
+#include "error_support.h"
+#include "fault_support.h"
 #include "lifecycle_support.h"
+#include "log_support.h"
+#include "mem_support.h"
+#include "notify_watchdog.h"
+#include "output_support.h"
+#include "profile_support.h"
+#include "relay_support.h"
+#include "rule_engine.h"
+#include "sample_schedule.h"
 #include "scan_support.h"
+#include "stats_support.h"
+#include "time_support.h"
+#include "uart_support.h"
 
+#include "app_timer.h"
 #include "bsp_btn_ble.h"
 #include "ble_hci.h"
 
@@ -24,6 +40,61 @@ void on_ble_gap_evt(ble_evt_t * p_ble_evt);
 
 static ble_db_discovery_t       m_ble_db_discovery;
 static st_client_t              m_ble_sensortag_client;
+static rule_engine_t            m_rule_engine;
+static command_parser_t         m_command_parser;
+static command_parser_t         m_relay_command_parser;
+static uint16_t                 m_conn_handle = BLE_CONN_HANDLE_INVALID;
+static st_client_t *            m_clients[LINK_COUNT];          // SensorTag client of each central link, by conn_handle
+static bool                     m_link_held;                    // Set by the disc command: stay disconnected until conn
+static ble_gap_addr_t           m_last_peer;                    // SensorTag of the most recent link, for reconnect_peer
+static bool                     m_last_peer_valid;
+static bool                     m_reconnecting;                 // A directed reconnect to m_last_peer is pending
+static uint64_t                 m_last_sample_ticks;            // Receive time of the latest notification
+static backpressure_t           m_backpressure;
+static uint32_t                 m_uart_dropped;                 // Bulk lane drops at the previous backpressure check
+static uint64_t                 m_schedule_base;                // Start of the sample schedule's first cycle on this link
+static bool                     m_schedule_valid;
+
+APP_TIMER_DEF(m_watchdog_timer);
+APP_TIMER_DEF(m_backpressure_timer);
+APP_TIMER_DEF(m_schedule_timer);
+
+/**@brief Sampling configuration, applied to each service as it is discovered and changed by commands.
+ */
+typedef struct
+{
+    uint16_t            uuid;
+    bool                enabled;
+    uint8_t             period;                                 // ST_CLIENT_PERIOD_UNIT_MS units, 0 keeps the tag's default
+    uint16_t            default_period_ms;                      // The tag's own period, watched while period is 0
+    bool                discovered;                             // Found on this link, so settings can be written
+    bool                pending;                                // Discovered on this link, settings not yet written
+    uint64_t            configure_at;                           // Slot in the sample schedule for the pending writes
+    bool                stretched;                              // The tag was last given a period stretched by backpressure
+    notify_watchdog_t   watchdog;                               // Running while the service is enabled on a link
+} service_config_t;
+
+static service_config_t m_service_config[] = {
+    { .uuid = BLE_UUID_ST_LUXO_SERVICE, .enabled = true, .default_period_ms = 800 },
+    { .uuid = BLE_UUID_ST_TEMP_SERVICE, .enabled = true, .default_period_ms = 1000 },
+};
+
+#define WATCHDOG_CHECK_INTERVAL_MS  250                         /**< How often the notification watchdogs are checked. */
+#define BACKPRESSURE_CHECK_INTERVAL_MS  500                     /**< How often the UART bulk lane is checked for congestion. */
+
+#define COMMAND_PERIOD_MIN_MS   100                             /**< Shortest period the SensorTag supports on any sensor. */
+#define COMMAND_PERIOD_MAX_MS   (UINT8_MAX * ST_CLIENT_PERIOD_UNIT_MS)
+
+/**@brief Alert and reporting rules, in raw sensor units (temperature is 1/128 C), rates per second.
+ */
+static const rule_t m_rules[] = {
+    { .stream = STREAM_TEMP, .value_index = 1, .kind = RULE_THRESHOLD_HIGH, .limit = 35 * 128, .hysteresis = 128 },
+    { .stream = STREAM_TEMP, .value_index = 1, .kind = RULE_THRESHOLD_LOW,  .limit =  5 * 128, .hysteresis = 128 },
+    { .stream = STREAM_TEMP, .value_index = 1, .kind = RULE_RATE_OF_CHANGE, .limit = 1 * 128 },
+    { .stream = STREAM_TEMP, .value_index = 0, .kind = RULE_DEAD_BAND,      .limit = 64 },
+    { .stream = STREAM_TEMP, .value_index = 1, .kind = RULE_DEAD_BAND,      .limit = 32 },
+    { .stream = STREAM_LUXO, .value_index = 0, .kind = RULE_DEAD_BAND,      .limit = 16 },
+};
 
 
 // Main Application ----------------------------------------------------------------------------------------------------
@@ -39,58 +110,186 @@ void application_main_loop(void)
 
 // Event handlers: UART events -----------------------------------------------------------------------------------------
 
-/**@brief       Function for handling UART events.
+/**@brief       Function for handling received UART bytes.
  *
  * @details     This handler will receive single bytes from the UART as and when they are ready.
- *              They are currently consumed without use; the UART is 'write only'
+ *              They are fed to the command parser, see on_command.
  */
-void uart_event_handler(app_uart_evt_t * p_event)
+void uart_rx_handler(uint8_t data)
 {
-    uint8_t data;
+    command_parser_put(&m_command_parser, data);
+}
 
-    switch (p_event->evt_type)
-    {
-        /**@snippet Simply consume each byte to prevent overflows */ 
-        case APP_UART_DATA_READY:
-            UNUSED_VARIABLE(app_uart_get(&data));
-            break;
-        case APP_UART_COMMUNICATION_ERROR:
-            APP_ERROR_HANDLER(p_event->data.error_communication);
-            break;
-        case APP_UART_FIFO_ERROR:
-            APP_ERROR_HANDLER(p_event->data.error_code);
-            break;
-        default:
-            break;
-    }
+/**@brief       Function for handling bytes written by a relay client.
+ *
+ * @details     The relay has its own command parser, so that lines from the two sources
+ *              are never mixed.
+ */
+void relay_rx_handler(uint8_t data)
+{
+    command_parser_put(&m_relay_command_parser, data);
 }
 
 // Event handlers: BLE events -----------------------------------------------------------------------------------------
 
-/**@brief Function for dispatching a BLE stack event to all modules with a BLE stack event handler.
+/**@brief Modules that take BLE stack events, as bits of ble_route_t.subscribers. */
+enum
+{
+    ROUTE_BSP       = 1 << 0,               // bsp_btn_ble: connection state for the buttons
+    ROUTE_DISCOVERY = 1 << 1,               // ble_db_discovery: GATT client procedures
+    ROUTE_GAP       = 1 << 2,               // on_ble_gap_evt
+    ROUTE_RELAY     = 1 << 3,               // relay_on_ble_evt: it holds the only GATT server
+    ROUTE_CLIENT    = 1 << 4,               // The SensorTag client of the event's link, from m_clients
+};
+
+/**@brief Subscribers to a range of evt_id values. */
+typedef struct
+{
+    uint8_t             first;
+    uint8_t             last;
+    uint8_t             subscribers;
+} ble_route_t;
+
+/**@brief Event routes, searched in order; the first range containing evt_id applies.
+ *
+ * @details Advertising reports come first: while scanning they are nearly every event, and
+ *          only the scanner needs them. Every event carries its conn_handle at the same offset,
+ *          which is how client events find their client.
+ */
+static const ble_route_t m_routes[] = {
+    { BLE_GAP_EVT_ADV_REPORT, BLE_GAP_EVT_ADV_REPORT,   ROUTE_GAP },
+    { BLE_GAP_EVT_CONNECTED,  BLE_GAP_EVT_DISCONNECTED, ROUTE_BSP | ROUTE_DISCOVERY | ROUTE_GAP | ROUTE_RELAY | ROUTE_CLIENT },
+    { BLE_GAP_EVT_BASE,       BLE_GAP_EVT_LAST,         ROUTE_GAP | ROUTE_RELAY },
+    { BLE_GATTC_EVT_BASE,     BLE_GATTC_EVT_LAST,       ROUTE_DISCOVERY | ROUTE_CLIENT },
+    { BLE_GATTS_EVT_BASE,     BLE_GATTS_EVT_LAST,       ROUTE_RELAY },
+    { BLE_EVT_BASE,           BLE_EVT_LAST,             ROUTE_RELAY },
+};
+
+static uint8_t route_subscribers(uint16_t evt_id)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_routes); ++i) {
+        if (evt_id >= m_routes[i].first && evt_id <= m_routes[i].last) {
+            return m_routes[i].subscribers;
+        }
+    }
+    return 0;
+}
+
+/**@brief   SensorTag client of a link. The SoftDevice numbers links from 0, so the handle is the index. */
+static st_client_t * client_get(uint16_t conn_handle)
+{
+    return (conn_handle < LINK_COUNT) ? m_clients[conn_handle] : NULL;
+}
+
+/**@brief Function for dispatching a BLE stack event to the modules subscribed to it.
  *
  * @details This function is called from the scheduler in the main loop after a BLE stack event has
- *          been received.
+ *          been received. See m_routes for which module receives what.
  *
  * @param[in] p_ble_evt  Bluetooth stack event.
  */
 void ble_evt_dispatch(ble_evt_t * p_ble_evt)
 {   
+    PROFILE_BEGIN(dispatch_start);
+
+    uint16_t evt_id = p_ble_evt->header.evt_id;
+    uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+    uint8_t subscribers = route_subscribers(evt_id);
+
+    // A new central link is the SensorTag's: register its client before the client sees the event
+    if (evt_id == BLE_GAP_EVT_CONNECTED && conn_handle < LINK_COUNT &&
+        p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_CENTRAL) {
+        m_clients[conn_handle] = &m_ble_sensortag_client;
+    }
+
     // Forward to the middleware: Nordic stack BSP to turn the indication blink / solid
-    bsp_btn_ble_on_ble_evt(p_ble_evt);
+    if (subscribers & ROUTE_BSP) {
+        bsp_btn_ble_on_ble_evt(p_ble_evt);
+    }
 
     // Forward to the middleware: Provided by the Nordic stack to process discovery events
     //  In turn: This middleware makes its own callback to the application
-    ble_db_discovery_on_ble_evt(&m_ble_db_discovery, p_ble_evt);
+    if (subscribers & ROUTE_DISCOVERY) {
+        ble_db_discovery_on_ble_evt(&m_ble_db_discovery, p_ble_evt);
+    }
 
     // Forward to the application: process BLE GAP events
-    on_ble_gap_evt(p_ble_evt);
+    if (subscribers & ROUTE_GAP) {
+        on_ble_gap_evt(p_ble_evt);
+    }
+
+    // Forward to the application: the peripheral link to a relay client
+    if (subscribers & ROUTE_RELAY) {
+        relay_on_ble_evt(p_ble_evt);
+    }
 
     // Forward to the application: Send TO Sensor Tag client
-    st_client_on_ble_evt(&m_ble_sensortag_client, p_ble_evt);
+    st_client_t * p_client = (subscribers & ROUTE_CLIENT) ? client_get(conn_handle) : NULL;
+    if (p_client != NULL) {
+        PROFILE_BEGIN(client_start);
+        st_client_on_ble_evt(p_client, p_ble_evt);
+        PROFILE_END(PROFILE_ST_CLIENT, client_start);
+    }
+
+    if (evt_id == BLE_GAP_EVT_DISCONNECTED && conn_handle < LINK_COUNT) {
+        m_clients[conn_handle] = NULL;
+    }
+
+    PROFILE_END(PROFILE_BLE_EVT_DISPATCH, dispatch_start);
 }
 
 
+/**@brief   Drop the SensorTag link; also the retry for ERROR_SITE_DISCONNECT. */
+static void link_disconnect(void)
+{
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+        return;
+    }
+    uint32_t err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    ERROR_CHECK(ERROR_SITE_DISCONNECT, err_code, link_disconnect);
+}
+
+/**@brief   Roll back to scanning after an error, see error_support.h.
+ *
+ * @details A connected link is dropped, and its disconnect event starts the scan.
+ */
+static void link_rollback(void)
+{
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID) {
+        link_disconnect();
+    }
+    else if (!m_link_held) {
+        scan_start();
+    }
+}
+
+/**@brief   Start service discovery on the SensorTag link; also the retry for ERROR_SITE_DISCOVERY_START. */
+static void discovery_start(void)
+{
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+        return;
+    }
+    uint32_t err_code = ble_db_discovery_start(&m_ble_db_discovery, m_conn_handle);
+    ERROR_CHECK(ERROR_SITE_DISCOVERY_START, err_code, discovery_start);
+}
+
+/**@brief   Find the SensorTag again after a link loss.
+ *
+ * @details The tag advertises again as soon as its side of the link times out, so a directed
+ *          connect to the last peer skips the scan and its advertising report. If that times
+ *          out, on_ble_gap_evt falls back to open scanning.
+ */
+static void link_reconnect(void)
+{
+    if (m_last_peer_valid && reconnect_peer(&m_last_peer)) {
+        m_reconnecting = true;
+        stats_increment(STATS_RECONNECT_DIRECT);
+    }
+    else {
+        scan_start();
+    }
+}
+
 /**@brief   Process the GAP events from the BLE Stack.
  *
  * @param[in] p_ble_evt  Bluetooth stack event.
@@ -114,45 +313,359 @@ void on_ble_gap_evt(ble_evt_t * p_ble_evt)
         }
 
         case BLE_GAP_EVT_CONNECTED:
-            printf("[GAP]: Connected to target\r\n");
+            // Relay clients are handled by relay_on_ble_evt
+            if (p_gap_evt->params.connected.role != BLE_GAP_ROLE_CENTRAL) {
+                break;
+            }
+            LOG("[GAP]: Connected to target");
+            m_conn_handle = p_gap_evt->conn_handle;
+            m_last_peer = p_gap_evt->params.connected.peer_addr;
+            m_last_peer_valid = true;
+            m_reconnecting = false;
+            stats_increment(STATS_CONNECTIONS);
+            stats_discovery_started(time_support_now());
             err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
-            APP_ERROR_CHECK(err_code);
+            ERROR_CHECK(ERROR_SITE_INDICATION, err_code, NULL);
 
-            err_code = ble_db_discovery_start(&m_ble_db_discovery, p_ble_evt->evt.gap_evt.conn_handle);
-            APP_ERROR_CHECK(err_code);
+            discovery_start();
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            if (p_gap_evt->conn_handle != m_conn_handle) {
+                break;
+            }
+            // The SensorTag client reports the disconnect to the application; only count it here
+            m_conn_handle = BLE_CONN_HANDLE_INVALID;
+            stats_disconnect(p_gap_evt->params.disconnected.reason);
             break;
 
         case BLE_GAP_EVT_TIMEOUT:
             if (p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_SCAN) {
-                printf("[GAP]: Scan timed out.\r\n");
+                LOG("[GAP]: Scan timed out.");
             }
             else if (p_gap_evt->params.timeout.src == BLE_GAP_TIMEOUT_SRC_CONN) {
-                printf("[GAP]: Connection Request timed out.\r\n");
+                LOG("[GAP]: Connection Request timed out.");
+                stats_increment(STATS_CONNECT_TIMEOUTS);
+                if (m_reconnecting) {
+                    m_reconnecting = false;
+                    stats_increment(STATS_RECONNECT_FALLBACK);
+                }
+            }
+            if (!m_link_held) {
+                scan_start();
             }
-            scan_start();
             break;
 
         case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
             // Pairing not supported
-            printf("[GAP]: Received sec params request: Not supported.\r\n");
+            LOG("[GAP]: Received sec params request: Not supported.");
             err_code = sd_ble_gap_sec_params_reply(p_ble_evt->evt.gap_evt.conn_handle,
                                                    BLE_GAP_SEC_STATUS_PAIRING_NOT_SUPP, NULL, NULL);
-            APP_ERROR_CHECK(err_code);
+            ERROR_CHECK(ERROR_SITE_SEC_PARAMS_REPLY, err_code, NULL);
             break;
 
         case BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST:
-            // Accepting parameters requested by peer.
-            printf("[GAP]: Connection parameter update request");
-            err_code = sd_ble_gap_conn_param_update(p_gap_evt->conn_handle,
-                                                    &p_gap_evt->params.conn_param_update_request.conn_params);
-            APP_ERROR_CHECK(err_code);
+        {
+            // Accepting parameters requested by peer, but keeping link loss detection fast
+            LOG("[GAP]: Connection parameter update request");
+            ble_gap_conn_params_t conn_params = p_gap_evt->params.conn_param_update_request.conn_params;
+            conn_params_limit(&conn_params);
+            err_code = sd_ble_gap_conn_param_update(p_gap_evt->conn_handle, &conn_params);
+            ERROR_CHECK(ERROR_SITE_CONN_PARAM_UPDATE, err_code, NULL);
             break;
+        }
     
         default:
             break;
     }
 }
 
+static service_config_t * service_config_get(uint16_t uuid)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+        if (m_service_config[i].uuid == uuid) {
+            return &m_service_config[i];
+        }
+    }
+    return NULL;
+}
+
+/**@brief   The sampling period of a service in ms, as configured and stretched by backpressure. */
+static uint32_t service_period_ms(const service_config_t * p_config)
+{
+    uint32_t period_ms = p_config->period ? p_config->period * ST_CLIENT_PERIOD_UNIT_MS
+                                          : p_config->default_period_ms;
+    return backpressure_period(&m_backpressure, period_ms, COMMAND_PERIOD_MAX_MS);
+}
+
+/**@brief   Start or stop the notification watchdog of a service to match its settings.
+ *
+ * @details Called once the settings are written to the tag, so that the first period is counted
+ *          from when the tag could start notifying.
+ */
+static void service_watch(service_config_t * p_config)
+{
+    if (!p_config->enabled || m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+        notify_watchdog_stop(&p_config->watchdog);
+        return;
+    }
+    notify_watchdog_start(&p_config->watchdog,
+                          service_period_ms(p_config) * TIME_TICKS_PER_SECOND / 1000, time_support_now());
+}
+
+/**@brief   Bring a discovered service to its configured period and on/off state.
+ *
+ * @details The tag's own period is left alone unless backpressure stretches it, or has
+ *          stretched it before and the default must be written back.
+ */
+static uint32_t service_configure(st_client_t * p_ble_st_c, const service_config_t * p_config)
+{
+    if (p_config->period || p_config->stretched || backpressure_level(&m_backpressure) > 0) {
+        VERIFY_SUCCESS(st_client_period_set(p_ble_st_c, p_config->uuid,
+                                            service_period_ms(p_config) / ST_CLIENT_PERIOD_UNIT_MS));
+    }
+    return service_enable(p_ble_st_c, p_config->uuid, p_config->enabled);
+}
+
+/**@brief   Configure every discovered service still pending; also the retry for ERROR_SITE_SERVICE_CONFIGURE.
+ *
+ * @details The writes fail while the SoftDevice is out of buffers, which is likely right after
+ *          discovery. Without a retry the service would stay off for the whole connection.
+ */
+static void services_configure(void)
+{
+    uint64_t now = time_support_now();
+    uint64_t next = UINT64_MAX;
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+        service_config_t * p_config = &m_service_config[i];
+        if (!p_config->pending) {
+            continue;
+        }
+        if (p_config->configure_at > now) {
+            next = MIN(next, p_config->configure_at);
+            continue;
+        }
+        if (ERROR_CHECK(ERROR_SITE_SERVICE_CONFIGURE,
+                        service_configure(&m_ble_sensortag_client, p_config), services_configure)) {
+            p_config->pending = false;
+            p_config->stretched = backpressure_level(&m_backpressure) > 0;
+            // A re-enable by the watchdog leaves it running, so that it can still escalate
+            if (!notify_watchdog_active(&p_config->watchdog)) {
+                service_watch(p_config);
+            }
+        }
+    }
+
+    if (next != UINT64_MAX) {
+        // RTC1 ticks are app_timer ticks at APP_TIMER_PRESCALER 0
+        uint32_t ticks = MAX((uint32_t)(next - now), APP_TIMER_TICKS(1, APP_TIMER_PRESCALER));
+        UNUSED_VARIABLE(app_timer_stop(m_schedule_timer));
+        // A full app_timer operation queue is transient: try the whole pass again later
+        uint32_t err_code = app_timer_start(m_schedule_timer, ticks, NULL);
+        ERROR_CHECK(ERROR_SITE_SERVICE_CONFIGURE, err_code, services_configure);
+    }
+}
+
+/**@brief   Give every pending service its slot in the sample schedule, then configure those due.
+ *
+ * @details The grid starts when the first service is scheduled on a link and is kept for the
+ *          whole link, so later writes (a watchdog re-enable, a backpressure step) fall back
+ *          into the same slots. A service that is off is written straight away.
+ */
+static void services_schedule(void)
+{
+    uint32_t periods[ARRAY_SIZE(m_service_config)];
+    uint32_t offsets[ARRAY_SIZE(m_service_config)];
+    uint64_t now = time_support_now();
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+        const service_config_t * p_config = &m_service_config[i];
+        periods[i] = p_config->enabled ? service_period_ms(p_config) * TIME_TICKS_PER_SECOND / 1000 : 0;
+    }
+    uint32_t cycle = sample_schedule_offsets(periods, ARRAY_SIZE(m_service_config), offsets);
+
+    if (!m_schedule_valid) {
+        m_schedule_base = now;
+        m_schedule_valid = true;
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+        service_config_t * p_config = &m_service_config[i];
+        if (p_config->pending) {
+            p_config->configure_at = p_config->enabled
+                                   ? sample_schedule_next(m_schedule_base, cycle, offsets[i], now)
+                                   : now;
+        }
+    }
+    services_configure();
+}
+
+static void schedule_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    services_configure();
+}
+
+static void schedule_init(void)
+{
+    uint32_t err_code = app_timer_create(&m_schedule_timer, APP_TIMER_MODE_SINGLE_SHOT, schedule_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+}
+
+/**@brief   A service was discovered: write its settings in its slot. */
+static void service_discovered(uint16_t uuid)
+{
+    service_config_t * p_config = service_config_get(uuid);
+    p_config->discovered = true;
+    p_config->pending = true;
+    services_schedule();
+}
+
+/**@brief   A command changed a service's settings: write them in its slot, retried like the others.
+ *
+ * @details The watchdog is restarted with the new period, or stopped, first, as for
+ *          backpressure. A service not yet discovered gets the settings with its discovery.
+ */
+static void service_changed(service_config_t * p_config)
+{
+    if (!p_config->discovered) {
+        return;
+    }
+    service_watch(p_config);
+    p_config->pending = true;
+    services_schedule();
+}
+
+/**@brief   Check every watched service for missed notifications.
+ *
+ * @details A silent service is enabled again, in case the tag lost its configuration; the write
+ *          goes through services_schedule so that it keeps its slot and is retried like the first one. If that
+ *          does not bring the notifications back the link is dropped, and the reconnect
+ *          rediscovers and reconfigures everything.
+ */
+static void watchdog_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    uint64_t now = time_support_now();
+    bool reenable = false;
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+        service_config_t * p_config = &m_service_config[i];
+        switch (notify_watchdog_check(&p_config->watchdog, now))
+        {
+            case NOTIFY_WATCHDOG_REENABLE:
+                LOG("[WDOG] 0x%04x silent, enabling again", p_config->uuid);
+                stats_increment(STATS_WATCHDOG_REENABLES);
+                p_config->pending = true;
+                reenable = true;
+                break;
+            case NOTIFY_WATCHDOG_DISCONNECT:
+                LOG("[WDOG] 0x%04x silent, reconnecting", p_config->uuid);
+                stats_increment(STATS_WATCHDOG_DISCONNECTS);
+                link_disconnect();
+                return;
+            default:
+                break;
+        }
+    }
+    // Once for all services, so that one tick queues a single restart of the schedule timer
+    if (reenable) {
+        services_schedule();
+    }
+}
+
+static void watchdog_init(void)
+{
+    uint32_t err_code = app_timer_create(&m_watchdog_timer, APP_TIMER_MODE_REPEATED, watchdog_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_start(m_watchdog_timer,
+                               APP_TIMER_TICKS(WATCHDOG_CHECK_INTERVAL_MS, APP_TIMER_PRESCALER),
+                               NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
+/**@brief   Check the UART bulk lane and slow the tag down, or speed it up again, to match.
+ *
+ * @details A new level is written to every service configured on the link through
+ *          services_schedule, so that each write keeps its slot and one that fails for lack of
+ *          buffers is retried. The
+ *          watchdog is restarted with the new period first; it would otherwise see a slowed
+ *          down service as a silent one.
+ */
+static void backpressure_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    // Only the bulk lane: a diagnostic burst on the urgent lane is no reason to slow the tag
+    uint32_t dropped = uart_dropped(UART_LANE_BULK);
+    backpressure_action_t action = backpressure_check(&m_backpressure, uart_peak(UART_LANE_BULK),
+                                                      dropped != m_uart_dropped);
+    m_uart_dropped = dropped;
+    if (action == BACKPRESSURE_HOLD) {
+        return;
+    }
+
+    uint8_t level = backpressure_level(&m_backpressure);
+    if (action == BACKPRESSURE_SLOW_DOWN) {
+        stats_increment(STATS_BACKPRESSURE_SLOWDOWNS);
+    }
+    stats_set(STATS_BACKPRESSURE_LEVEL, level);
+    LOG("[FLOW] sampling periods x%u", 1u << level);
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+        service_config_t * p_config = &m_service_config[i];
+        if (notify_watchdog_active(&p_config->watchdog)) {
+            service_watch(p_config);
+            p_config->pending = true;
+        }
+    }
+    services_schedule();
+}
+
+static void backpressure_timer_init(void)
+{
+    backpressure_init(&m_backpressure);
+
+    uint32_t err_code = app_timer_create(&m_backpressure_timer, APP_TIMER_MODE_REPEATED,
+                                         backpressure_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_start(m_backpressure_timer,
+                               APP_TIMER_TICKS(BACKPRESSURE_CHECK_INTERVAL_MS, APP_TIMER_PRESCALER),
+                               NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
+/**@brief   Apply the rules to a decoded sample and output it unless it is suppressed.
+ */
+static void on_sample(stream_id_t stream, st_client_evt_type_t evt_type, const st_client_data_t * p_data)
+{
+    if (!p_data->valid) {
+        stats_increment(STATS_DECODE_FAILED);
+        return;
+    }
+
+    PROFILE_BEGIN(rules_start);
+    bool report = rule_engine_evaluate(&m_rule_engine, stream, p_data->timestamp, p_data->raw);
+    PROFILE_END(PROFILE_RULES, rules_start);
+
+    if (report) {
+        PROFILE_BEGIN(output_start);
+        output_sample(evt_type, p_data);
+        PROFILE_END(PROFILE_OUTPUT, output_start);
+    }
+    else {
+        stats_increment(STATS_SAMPLES_SUPPRESSED);
+    }
+}
+
+/**@brief   Note a notification: it ends the data gap of a link loss. */
+static void on_notification(uint64_t ticks)
+{
+    m_last_sample_ticks = ticks;
+    stats_gap_finished(ticks);
+}
+
 /**@brief   Process events received FROM the SensorTag Client 
  *
  * @details This function processes the 'user events' from the client. The client handles the 
@@ -163,28 +676,44 @@ void ble_st_c_evt_handler(st_client_t * p_ble_st_c, const st_client_evt_t * p_st
     switch(p_st_c_evt->evt_type)
     {
         case ST_CLIENT_EVT_LUXO_DISCOVERED:
-            service_enable(p_ble_st_c, BLE_UUID_ST_LUXO_SERVICE, true); 
+            service_discovered(BLE_UUID_ST_LUXO_SERVICE);
             break;
         case ST_CLIENT_EVT_TEMP_DISCOVERED:
-            service_enable(p_ble_st_c, BLE_UUID_ST_TEMP_SERVICE, true); 
+            service_discovered(BLE_UUID_ST_TEMP_SERVICE);
             break;
         case ST_CLIENT_EVT_LUXO_DATA:
+            stats_increment(STATS_NOTIFY_LUXO);
+            notify_watchdog_feed(&service_config_get(BLE_UUID_ST_LUXO_SERVICE)->watchdog, p_st_c_evt->timestamp);
+            on_notification(p_st_c_evt->timestamp);
+            PROFILE_BEGIN(luxo_start);
             st_client_data_t luxo = extract_luxometer_data(p_st_c_evt); 
-            if (luxo.valid) {
-                printf("Lux value: %i\n", luxo.luxo_data);
-            }
+            PROFILE_END(PROFILE_DECODE, luxo_start);
+            on_sample(STREAM_LUXO, p_st_c_evt->evt_type, &luxo);
             break;
         case ST_CLIENT_EVT_TEMP_DATA:
+            stats_increment(STATS_NOTIFY_TEMP);
+            notify_watchdog_feed(&service_config_get(BLE_UUID_ST_TEMP_SERVICE)->watchdog, p_st_c_evt->timestamp);
+            on_notification(p_st_c_evt->timestamp);
+            PROFILE_BEGIN(temp_start);
             st_client_data_t temp = extract_temperature_data(p_st_c_evt); 
-            if (temp.valid) {
-                printf("IR Temp: %3.2f\t Ambient Temp: %3.2f\n", 
-                       temp.temp_data.ir_data,
-                       temp.temp_data.amb_data);
-            }
+            PROFILE_END(PROFILE_DECODE, temp_start);
+            on_sample(STREAM_TEMP, p_st_c_evt->evt_type, &temp);
             break;
         case ST_CLIENT_EVT_DISCONNECTED:
-            printf("Disconnected!\n");
-            scan_start();
+            for (uint8_t i = 0; i < ARRAY_SIZE(m_service_config); ++i) {
+                m_service_config[i].discovered = false;
+                m_service_config[i].pending = false;
+                notify_watchdog_stop(&m_service_config[i].watchdog);
+            }
+            m_schedule_valid = false;
+            rule_engine_reset(&m_rule_engine);
+            output_flush();
+            LOG("Disconnected!");
+            if (!m_link_held) {
+                // Before the first sample ever there is nothing to measure from but now
+                stats_gap_started(m_last_sample_ticks ? m_last_sample_ticks : time_support_now());
+                link_reconnect();
+            }
             break;
         default:
             break;
@@ -201,15 +730,225 @@ void ble_st_c_evt_handler(st_client_t * p_ble_st_c, const st_client_evt_t * p_st
  */
 void db_disc_handler(ble_db_discovery_evt_t * p_evt)
 {
+    // The discovery module is available again once every registered service has been tried
+    if (p_evt->evt_type == BLE_DB_DISCOVERY_AVAILABLE) {
+        stats_discovery_finished(time_support_now());
+    }
     st_client_on_db_disc_evt(&m_ble_sensortag_client, p_evt);
 }
 
 
+// Commands -----------------------------------------------------------------------------------------------------------
+
+/**@brief   Service named by a command argument, "luxo" or "temp". */
+static service_config_t * command_service(const command_t * p_command, uint8_t index)
+{
+    if (index >= p_command->count) {
+        return NULL;
+    }
+    switch (p_command->tokens[index].word)
+    {
+        case COMMAND_WORD('l', 'u', 'x', 'o'):
+            return service_config_get(BLE_UUID_ST_LUXO_SERVICE);
+        case COMMAND_WORD('t', 'e', 'm', 'p'):
+            return service_config_get(BLE_UUID_ST_TEMP_SERVICE);
+        default:
+            return NULL;
+    }
+}
+
+/**@brief   True if the command has an argument at index that is the given word. */
+static bool command_arg_is(const command_t * p_command, uint8_t index, uint32_t word)
+{
+    return index < p_command->count && p_command->tokens[index].word == word;
+}
+
+/**@brief   on|off luxo|temp: switch a service; remembered across reconnects. */
+static uint32_t command_enable(const command_t * p_command, bool enable)
+{
+    service_config_t * p_config = command_service(p_command, 1);
+    if (p_config == NULL) {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    p_config->enabled = enable;
+    service_changed(p_config);
+    return NRF_SUCCESS;
+}
+
+/**@brief   peri luxo|temp <ms>: set a sampling period; remembered across reconnects. */
+static uint32_t command_period(const command_t * p_command)
+{
+    service_config_t * p_config = command_service(p_command, 1);
+    if (p_config == NULL || p_command->count != 3 || !p_command->tokens[2].is_number ||
+        p_command->tokens[2].number < COMMAND_PERIOD_MIN_MS ||
+        p_command->tokens[2].number > COMMAND_PERIOD_MAX_MS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    p_config->period = p_command->tokens[2].number / ST_CLIENT_PERIOD_UNIT_MS;
+    service_changed(p_config);
+    return NRF_SUCCESS;
+}
+
+/**@brief   fmt text|comp: switch the output format. */
+static uint32_t command_format(const command_t * p_command)
+{
+    if (command_arg_is(p_command, 1, COMMAND_WORD('t', 'e', 'x', 't'))) {
+        output_format_set(OUTPUT_FORMAT_TEXT);
+    }
+    else if (command_arg_is(p_command, 1, COMMAND_WORD('c', 'o', 'm', 'p'))) {
+        output_format_set(OUTPUT_FORMAT_COMPRESSED);
+    }
+    else {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    return NRF_SUCCESS;
+}
+
+/**@brief   disc: drop the link, or stop scanning, and stay disconnected until conn. */
+static uint32_t command_disconnect(void)
+{
+    m_link_held = true;
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID) {
+        return sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+    }
+    // Either may be in progress; the other fails harmlessly with NRF_ERROR_INVALID_STATE
+    UNUSED_VARIABLE(sd_ble_gap_connect_cancel());
+    UNUSED_VARIABLE(sd_ble_gap_scan_stop());
+    return bsp_indication_set(BSP_INDICATE_IDLE);
+}
+
+/**@brief   conn: resume scanning and reconnect after disc. */
+static uint32_t command_connect(void)
+{
+    if (!m_link_held) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    m_link_held = false;
+    // Still connected: the disconnect is in progress, and its event starts the scan
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+        scan_start();
+    }
+    return NRF_SUCCESS;
+}
+
+/**@brief   sync <s> <us>: echo a host timestamp with the current tick count.
+ *
+ * @details The host stamps the command when it sends it and the reply when it arrives; the
+ *          ticks were read in between. host/time_sync.h turns these exchanges into a mapping
+ *          from ticks to host time. printf has no 64 bit support, so the ticks are written
+ *          in two parts.
+ */
+static uint32_t command_sync(const command_t * p_command)
+{
+    uint64_t ticks = time_support_now();
+    if (p_command->count != 3 || !p_command->tokens[1].is_number || !p_command->tokens[2].is_number ||
+        p_command->tokens[2].number >= 1000000)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    unsigned long high = (unsigned long)(ticks / 1000000000u);
+    unsigned long low = (unsigned long)(ticks % 1000000000u);
+    if (high != 0) {
+        printf("[SYNC] %lu %lu %lu%09lu\n", (unsigned long)p_command->tokens[1].number,
+               (unsigned long)p_command->tokens[2].number, high, low);
+    }
+    else {
+        printf("[SYNC] %lu %lu %lu\n", (unsigned long)p_command->tokens[1].number,
+               (unsigned long)p_command->tokens[2].number, low);
+    }
+    return NRF_SUCCESS;
+}
+
+/**@brief   Execute a line from the UART command parser and reply with its result.
+ *
+ * @details help                     List the commands
+ *          on|off luxo|temp         Switch a service on or off
+ *          peri luxo|temp <ms>      Set a sampling period, 100 to 2550 ms in 10 ms steps
+ *          fmt text|comp            Select text or compressed output
+ *          stat [reset]             Dump or clear the runtime counters
+ *          prof [reset]             Dump or clear the latency histograms
+ *          mem                      Print RAM use and the stack high-water mark
+ *          sync <s> <us>            Echo a host timestamp with the current tick count
+ *          disc                     Disconnect and stay disconnected
+ *          conn                     Reconnect after disc
+ *
+ *          Service settings are kept and applied again whenever the SensorTag is rediscovered.
+ */
+static void on_command(void * p_context, const command_t * p_command)
+{
+    UNUSED_PARAMETER(p_context);
+    uint32_t err_code = NRF_SUCCESS;
+
+    if (p_command == NULL) {
+        printf("[CMD] error: malformed line\n");
+        return;
+    }
+
+    switch (p_command->tokens[0].word)
+    {
+        case COMMAND_WORD('h', 'e', 'l', 'p'):
+            printf("[CMD] on|off luxo|temp, peri luxo|temp <ms>, fmt text|comp, "
+                   "stat [reset], prof [reset], mem, sync <s> <us>, disc, conn\n");
+            break;
+        case COMMAND_WORD('o', 'n', 0, 0):
+            err_code = command_enable(p_command, true);
+            break;
+        case COMMAND_WORD('o', 'f', 'f', 0):
+            err_code = command_enable(p_command, false);
+            break;
+        case COMMAND_WORD('p', 'e', 'r', 'i'):
+            err_code = command_period(p_command);
+            break;
+        case COMMAND_WORD('f', 'm', 't', 0):
+            err_code = command_format(p_command);
+            break;
+        case COMMAND_WORD('s', 't', 'a', 't'):
+            if (command_arg_is(p_command, 1, COMMAND_WORD('r', 'e', 's', 'e'))) {
+                stats_reset();
+            }
+            else if (!stats_dump()) {
+                err_code = NRF_ERROR_BUSY;
+            }
+            break;
+        case COMMAND_WORD('p', 'r', 'o', 'f'):
+            if (command_arg_is(p_command, 1, COMMAND_WORD('r', 'e', 's', 'e'))) {
+                profile_reset();
+            }
+            else if (!profile_dump()) {
+                err_code = NRF_ERROR_BUSY;
+            }
+            break;
+        case COMMAND_WORD('m', 'e', 'm', 0):
+            mem_support_report();
+            break;
+        case COMMAND_WORD('s', 'y', 'n', 'c'):
+            err_code = command_sync(p_command);
+            break;
+        case COMMAND_WORD('d', 'i', 's', 'c'):
+            err_code = command_disconnect();
+            break;
+        case COMMAND_WORD('c', 'o', 'n', 'n'):
+            err_code = command_connect();
+            break;
+        default:
+            err_code = NRF_ERROR_NOT_SUPPORTED;
+            break;
+    }
+
+    if (err_code == NRF_SUCCESS) {
+        printf("[CMD] ok\n");
+    }
+    else {
+        printf("[CMD] error 0x%lx\n", (unsigned long)err_code);
+    }
+}
+
+
 // Event handlers: Hardware events (buttons and inactivity timers --------------------------------------------------------------------------------
 
 void bsp_event_handler(bsp_event_t event)
 {
-    uint32_t err_code;
     switch (event)
     {
         case BSP_EVENT_SLEEP:
@@ -219,12 +958,7 @@ void bsp_event_handler(bsp_event_t event)
         // If a disconnect hardware button is pressed, disconnect and inform the remote user:
         // From their perspective, we are the remote user that is terminating the connection
         case BSP_EVENT_DISCONNECT:
-            err_code = sd_ble_gap_disconnect(m_ble_sensortag_client.conn_handle,
-                                             BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-            if (err_code != NRF_ERROR_INVALID_STATE)
-            {
-                APP_ERROR_CHECK(err_code);
-            }
+            link_disconnect();
             break;
 
         default:
@@ -238,10 +972,23 @@ void bsp_event_handler(bsp_event_t event)
 
 void initialize_application()
 {
+    mem_support_init();
     timer_init();
-    uart_init(uart_event_handler);
+    error_support_init(link_rollback);
+    time_support_init();
+    watchdog_init();
+    backpressure_timer_init();
+    schedule_init();
+    profile_init();
+    command_parser_init(&m_command_parser, on_command, NULL);
+    command_parser_init(&m_relay_command_parser, on_command, NULL);
+    uart_init(uart_rx_handler);
+    output_init(OUTPUT_FORMAT_DEFAULT);
+    fault_support_report();
+    rule_engine_init(&m_rule_engine, m_rules, ARRAY_SIZE(m_rules), output_alert);
     buttons_leds_init(bsp_event_handler);
     db_discovery_init(db_disc_handler);
     ble_stack_init(ble_evt_dispatch);
-    st_c_init(&m_ble_sensortag_client, ble_st_c_evt_handler);
+    st_c_init(&m_ble_sensortag_client, ble_st_c_evt_handler, time_support_now);
+    relay_init(relay_rx_handler);
 }
@@ -0,0 +1,150 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "fault_support.h"
+#include "stats_support.h"
+
+#include "app_error.h"
+#include "hardfault.h"
+#include "nrf.h"
+
+#define FAULT_RECORD_MAGIC      0x46415554                      /**< "FAUT" */
+
+typedef struct
+{
+    uint32_t            magic;
+    uint32_t            resets;                                 // Fault resets since power on
+    uint32_t            valid;                                  // The fields below hold an unreported fault
+    uint32_t            id;                                     // NRF_FAULT_ID_* or FAULT_ID_HARDFAULT
+    uint32_t            err_code;
+    uint32_t            line;
+    char                file[FAULT_FILE_LEN];
+    uint32_t            pc;
+    uint32_t            lr;
+    uint32_t            connections;                            // Key counters at the time of the fault
+    uint32_t            notifications;
+    uint32_t            last_error;
+    uint32_t            checksum;
+} fault_record_t;
+
+static fault_record_t m_record __attribute__((section(".noinit")));
+
+
+static uint32_t record_checksum(const fault_record_t * p_record)
+{
+    const uint32_t * p_word = (const uint32_t *)p_record;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < offsetof(fault_record_t, checksum) / sizeof(uint32_t); ++i) {
+        sum = (sum << 1 | sum >> 31) ^ p_word[i];
+    }
+    return sum;
+}
+
+static bool record_intact(void)
+{
+    return m_record.magic == FAULT_RECORD_MAGIC && m_record.checksum == record_checksum(&m_record);
+}
+
+/**@brief Fill the record and reset. Runs in fault context: no SoftDevice calls, no printf. */
+static void record_and_reset(uint32_t id, uint32_t err_code, uint32_t line, const uint8_t * p_file,
+                             uint32_t pc, uint32_t lr)
+{
+    uint32_t resets = record_intact() ? m_record.resets : 0;
+
+    memset(&m_record, 0, sizeof(m_record));
+    m_record.magic = FAULT_RECORD_MAGIC;
+    m_record.resets = resets + 1;
+    m_record.valid = 1;
+    m_record.id = id;
+    m_record.err_code = err_code;
+    m_record.line = line;
+    if (p_file != NULL) {
+        // Keep the end of the path: the file name is what matters
+        size_t len = strlen((const char *)p_file);
+        size_t start = (len >= FAULT_FILE_LEN) ? len - (FAULT_FILE_LEN - 1) : 0;
+        memcpy(m_record.file, &p_file[start], len - start);
+    }
+    m_record.pc = pc;
+    m_record.lr = lr;
+    m_record.connections = stats_get(STATS_CONNECTIONS);
+    m_record.notifications = stats_get(STATS_NOTIFY_LUXO) + stats_get(STATS_NOTIFY_TEMP);
+    m_record.last_error = stats_get(STATS_ERROR_LAST_CODE);
+    m_record.checksum = record_checksum(&m_record);
+
+    NVIC_SystemReset();
+}
+
+/**@brief Overrides the SDK's weak handler, which resets without leaving a trace. */
+void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
+{
+    __disable_irq();
+
+    switch (id)
+    {
+        case NRF_FAULT_ID_SDK_ERROR:
+        {
+            const error_info_t * p_info = (const error_info_t *)info;
+            record_and_reset(id, p_info->err_code, p_info->line_num, p_info->p_file_name, pc, 0);
+            break;
+        }
+        case NRF_FAULT_ID_SDK_ASSERT:
+        {
+            const assert_info_t * p_info = (const assert_info_t *)info;
+            record_and_reset(id, 0, p_info->line_num, p_info->p_file_name, pc, 0);
+            break;
+        }
+        default:
+            // SoftDevice assert: pc is where it failed; memory access violation: info is the address
+            record_and_reset(id, info, 0, NULL, pc, 0);
+            break;
+    }
+}
+
+/**@brief Overrides the weak default in hardfault_implementation.c, which only resets. */
+void HardFault_process(HardFault_stack_t * p_stack)
+{
+    record_and_reset(FAULT_ID_HARDFAULT, 0, 0, NULL, p_stack->pc, p_stack->lr);
+}
+
+void fault_support_report(void)
+{
+    uint32_t reset_reason = NRF_POWER->RESETREAS;
+    NRF_POWER->RESETREAS = reset_reason;                        // Write 1 to clear
+    printf("[BOOT] reset reason 0x%lx\r\n", (unsigned long)reset_reason);
+
+    if (!record_intact()) {
+        memset(&m_record, 0, sizeof(m_record));
+        m_record.magic = FAULT_RECORD_MAGIC;
+        m_record.checksum = record_checksum(&m_record);
+        return;
+    }
+    if (m_record.valid) {
+        printf("[FAULT] id 0x%lx code 0x%lx at %s:%lu pc 0x%08lx lr 0x%08lx\r\n",
+               (unsigned long)m_record.id, (unsigned long)m_record.err_code,
+               m_record.file[0] ? m_record.file : "?", (unsigned long)m_record.line,
+               (unsigned long)m_record.pc, (unsigned long)m_record.lr);
+        printf("[FAULT] resets %lu connections %lu notifications %lu last_error 0x%lx\r\n",
+               (unsigned long)m_record.resets, (unsigned long)m_record.connections,
+               (unsigned long)m_record.notifications, (unsigned long)m_record.last_error);
+        m_record.valid = 0;
+        m_record.checksum = record_checksum(&m_record);
+    }
+}
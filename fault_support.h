@@ -0,0 +1,41 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef FAULT_SUPPORT_H
+#define FAULT_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Fault record kept across resets.
+ *
+ * @details  app_error_fault_handler (errors, SDK and SoftDevice asserts, including
+ *           assert_nrf_callback's 0xDEADBEEF) and HardFault_process (from the SDK's hardfault
+ *           handler) are overridden to write a record to the .noinit section before resetting.
+ *           The startup code does not clear .noinit, so the record survives the reset; a
+ *           power cycle leaves garbage there, which the magic word and checksum reject.
+ *
+ *           fault_support_report prints the record on the next boot and clears it, so each
+ *           fault is reported once. The count of fault resets survives until power is removed.
+ */
+
+#include <stdint.h>
+
+#define FAULT_ID_HARDFAULT      0x4100                          /**< Not an SDK fault id: CPU HardFault. */
+#define FAULT_FILE_LEN          20                              /**< Tail of the file name kept, with terminator. */
+
+/**@brief   Print the previous fault, if any, and the reset reason. Call once the UART is up. */
+void fault_support_report(void);
+
+#endif // FAULT_SUPPORT_H
@@ -0,0 +1,203 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fmt_support.h"
+
+#define FMT_UINT_MAX_DIGITS     10                              /**< Digits of UINT32_MAX. */
+#define FMT_FORMAT_MAX_WIDTH    32                              /**< Widths in fmt_format formats are cut to this. */
+
+static const uint32_t m_pow10[FMT_FIXED_MAX_DIGITS + 1] = { 1, 10, 100, 1000, 10000 };
+
+void fmt_init(fmt_t * p_fmt, char * p_buf, uint16_t size)
+{
+    p_fmt->p_buf = p_buf;
+    p_fmt->size = size;
+    p_fmt->len = 0;
+}
+
+void fmt_char(fmt_t * p_fmt, char c)
+{
+    if (p_fmt->len < p_fmt->size) {
+        p_fmt->p_buf[p_fmt->len++] = c;
+    }
+}
+
+void fmt_str(fmt_t * p_fmt, const char * p_str)
+{
+    while (*p_str != '\0') {
+        fmt_char(p_fmt, *p_str++);
+    }
+}
+
+void fmt_uint(fmt_t * p_fmt, uint32_t value, uint8_t width)
+{
+    char digits[FMT_UINT_MAX_DIGITS];
+    uint8_t count = 0;
+
+    // Least significant first
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+
+    for (; width > count; --width) {
+        fmt_char(p_fmt, '0');
+    }
+    while (count > 0) {
+        fmt_char(p_fmt, digits[--count]);
+    }
+}
+
+void fmt_int(fmt_t * p_fmt, int32_t value)
+{
+    if (value < 0) {
+        fmt_char(p_fmt, '-');
+    }
+    // Negated as unsigned, so that INT32_MIN does not overflow
+    fmt_uint(p_fmt, (value < 0) ? 0u - (uint32_t)value : (uint32_t)value, 0);
+}
+
+void fmt_fixed(fmt_t * p_fmt, int32_t value, uint8_t frac_bits, uint8_t digits)
+{
+    uint32_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+    uint32_t scale = m_pow10[digits];
+
+    // magnitude * 10^digits / 2^frac_bits, rounded half to even; 64 bits hold the product
+    uint64_t scaled = (uint64_t)magnitude * scale;
+    uint64_t half = (frac_bits > 0) ? (uint64_t)1 << (frac_bits - 1) : 0;
+    uint64_t rest = scaled & (((uint64_t)1 << frac_bits) - 1);
+    uint32_t units = (uint32_t)(scaled >> frac_bits);
+    if (frac_bits > 0 && (rest > half || (rest == half && (units & 1)))) {
+        ++units;
+    }
+
+    // printf keeps the sign of a negative value that rounds to zero
+    if (value < 0) {
+        fmt_char(p_fmt, '-');
+    }
+    fmt_uint(p_fmt, units / scale, 0);
+    if (digits > 0) {
+        fmt_char(p_fmt, '.');
+        fmt_uint(p_fmt, units % scale, digits);
+    }
+}
+
+void fmt_hex(fmt_t * p_fmt, uint32_t value, uint8_t width)
+{
+    char digits[8];
+    uint8_t count = 0;
+
+    do {
+        digits[count++] = "0123456789abcdef"[value & 0xF];
+        value >>= 4;
+    } while (value != 0);
+
+    for (; width > count; --width) {
+        fmt_char(p_fmt, '0');
+    }
+    while (count > 0) {
+        fmt_char(p_fmt, digits[--count]);
+    }
+}
+
+void fmt_format(fmt_t * p_fmt, const char * p_format, const int32_t * p_args, uint8_t count)
+{
+    uint8_t arg = 0;
+
+    while (*p_format != '\0') {
+        if (*p_format != '%') {
+            fmt_char(p_fmt, *p_format++);
+            continue;
+        }
+        ++p_format;
+        if (*p_format == '%') {
+            fmt_char(p_fmt, *p_format++);
+            continue;
+        }
+
+        bool left = false;
+        char pad = ' ';
+        for (; *p_format == '-' || *p_format == '0'; ++p_format) {
+            if (*p_format == '-') {
+                left = true;
+            }
+            else {
+                pad = '0';
+            }
+        }
+        uint16_t width = 0;
+        for (; *p_format >= '0' && *p_format <= '9'; ++p_format) {
+            width = width * 10 + (*p_format - '0');
+            if (width > FMT_FORMAT_MAX_WIDTH) {
+                width = FMT_FORMAT_MAX_WIDTH;
+            }
+        }
+        while (*p_format == 'l' || *p_format == 'h') {
+            ++p_format;
+        }
+        if (*p_format == '\0') {
+            break;
+        }
+
+        // The value goes to its own buffer first, so that it can be padded on either side
+        char digits[FMT_UINT_MAX_DIGITS + 1];
+        fmt_t value;
+        fmt_init(&value, digits, sizeof(digits));
+        char conversion = *p_format++;
+        if (arg == count) {
+            fmt_char(&value, '?');
+        }
+        else {
+            int32_t word = p_args[arg++];
+            switch (conversion) {
+                case 'd':
+                case 'i':
+                    fmt_int(&value, word);
+                    break;
+                case 'u':
+                    fmt_uint(&value, (uint32_t)word, 0);
+                    break;
+                case 'x':
+                case 'X':
+                    fmt_hex(&value, (uint32_t)word, 0);
+                    break;
+                case 'c':
+                    fmt_char(&value, (char)word);
+                    break;
+                default:
+                    fmt_char(&value, '?');
+                    break;
+            }
+        }
+
+        uint16_t start = 0;
+        if (!left && pad == '0' && digits[0] == '-') {
+            fmt_char(p_fmt, '-');       // zero padding goes after the sign
+            start = 1;
+        }
+        for (uint16_t i = value.len; !left && i < width; ++i) {
+            fmt_char(p_fmt, pad);
+        }
+        for (uint16_t i = start; i < value.len; ++i) {
+            fmt_char(p_fmt, digits[i]);
+        }
+        for (uint16_t i = value.len; left && i < width; ++i) {
+            fmt_char(p_fmt, ' ');
+        }
+    }
+}
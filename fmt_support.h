@@ -0,0 +1,99 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef FMT_SUPPORT_H
+#define FMT_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Integer-only text formatting for the text output mode.
+ *
+ * @details  A line is built piece by piece into a caller's buffer, then written in one go.
+ *           Fractional values are fixed point: a raw sensor word with a binary scale, printed
+ *           with a fixed number of decimals and rounded half to even on the exact value, the
+ *           same digits as printf's %.Nf gives for it. Nothing here needs float support in
+ *           printf, and the only divisions are by 10, on 32 bit words.
+ *
+ *           Pieces that do not fit are cut off; the line is not NUL terminated.
+ *
+ * @note     This module has no SDK dependencies.
+ */
+
+#include <stdint.h>
+
+#define FMT_FIXED_MAX_DIGITS    4                               /**< Most decimals fmt_fixed writes. */
+
+/**@brief A line being built. */
+typedef struct
+{
+    char                *p_buf;
+    uint16_t            size;
+    uint16_t            len;
+} fmt_t;
+
+
+/**@brief   Start a line in p_buf. */
+void fmt_init(fmt_t * p_fmt, char * p_buf, uint16_t size);
+
+/**@brief   Append one character. */
+void fmt_char(fmt_t * p_fmt, char c);
+
+/**@brief   Append a NUL terminated string. */
+void fmt_str(fmt_t * p_fmt, const char * p_str);
+
+/**@brief   Append an unsigned decimal, as %0*lu.
+ *
+ * @param[in] p_fmt     Line
+ * @param[in] value     Value
+ * @param[in] width     Zero padded to at least this many digits, 0 for none
+ */
+void fmt_uint(fmt_t * p_fmt, uint32_t value, uint8_t width);
+
+/**@brief   Append a signed decimal, as %li. */
+void fmt_int(fmt_t * p_fmt, int32_t value);
+
+/**@brief   Append value / 2^frac_bits with a fixed number of decimals, as %.*f.
+ *
+ * @param[in] p_fmt     Line
+ * @param[in] value     Fixed point value, e.g. a temperature in 1/128 C
+ * @param[in] frac_bits Binary fraction bits of value, at most 16
+ * @param[in] digits    Decimals, at most FMT_FIXED_MAX_DIGITS
+ *
+ * @note    |value| * 10^digits / 2^frac_bits must fit 32 bits.
+ */
+void fmt_fixed(fmt_t * p_fmt, int32_t value, uint8_t frac_bits, uint8_t digits);
+
+/**@brief   Append lower case hex, as %0*lx; with width 8 a full address.
+ *
+ * @param[in] p_fmt     Line
+ * @param[in] value     Value
+ * @param[in] width     Zero padded to at least this many digits, 0 for none
+ */
+void fmt_hex(fmt_t * p_fmt, uint32_t value, uint8_t width);
+
+/**@brief   Append a printf style format with 32 bit integer arguments, for LOG in text mode.
+ *
+ * @details Handles %%, the '-' and '0' flags, a width and the conversions d, i, u, x and c;
+ *          X prints lower case, and length modifiers are skipped since every argument is an
+ *          int32_t. Any other conversion, or one past the last argument, prints as '?'.
+ *
+ * @param[in] p_fmt     Line
+ * @param[in] p_format  Format, NUL terminated
+ * @param[in] p_args    Arguments
+ * @param[in] count     Number of arguments
+ */
+void fmt_format(fmt_t * p_fmt, const char * p_format, const int32_t * p_args, uint8_t count);
+
+#endif // FMT_SUPPORT_H
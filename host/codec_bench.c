@@ -0,0 +1,228 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Compression ratio and encode cost of the compressed output format.
+ *
+ * @details  Replays sample traces through the firmware's stream_codec.c, flushing frames the
+ *           way output_support.c does (full frame, or OUTPUT_FLUSH_INTERVAL_MS elapsed), and
+ *           compares the bytes sent against the text output and a plain fixed-width binary
+ *           encoding. Every run decodes its own output and checks values and timestamps against
+ *           the trace.
+ *
+ *           -w appends the compressed stream to a capture file, as the gateway would send it
+ *           over the UART, for replay through st_ingestd.
+ *
+ *           usage: codec_bench [-i flush_interval_ms] [-w capture] [trace.csv ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stream_codec.h"
+#include "trace.h"
+
+#define FLUSH_INTERVAL_MS       5000                            /**< Matches OUTPUT_FLUSH_INTERVAL_MS */
+#define TIMING_REPEATS          200
+
+static uint64_t m_flush_interval_ticks = FLUSH_INTERVAL_MS * 32768ULL / 1000;
+static FILE * mp_capture;
+
+typedef struct
+{
+    const trace_t       *p_trace;
+    size_t              next[STREAM_COUNT];
+    size_t              decoded;
+    size_t              mismatches;
+} verify_ctx_t;
+
+static size_t text_bytes(const trace_sample_t * p_sample)
+{
+    char line[80];
+    uint64_t ms = p_sample->ticks * 1000 / 32768;
+    size_t len = snprintf(line, sizeof(line), "[%lu.%03lu] #%u ",
+                          (unsigned long)(ms / 1000), (unsigned long)(ms % 1000), p_sample->seq);
+    if (p_sample->stream == STREAM_LUXO) {
+        return len + snprintf(line, sizeof(line), "Lux value: %i\n", (int)p_sample->values[0]);
+    }
+    return len + snprintf(line, sizeof(line), "IR Temp: %3.2f\t Ambient Temp: %3.2f\n",
+                          0.0078125 * p_sample->values[0], 0.0078125 * p_sample->values[1]);
+}
+
+/**@brief Encode the whole trace; returns the bytes produced. p_out may be NULL when timing. */
+static size_t encode_trace(const trace_t * p_trace, uint8_t * p_out)
+{
+    static uint8_t scratch[STREAM_FRAME_MAX_ENCODED];
+    stream_encoder_t encoder;
+    size_t total = 0;
+    uint64_t frame_start = 0;
+
+    stream_encoder_init(&encoder);
+    for (size_t i = 0; i < p_trace->count; ++i) {
+        const trace_sample_t * p_sample = &p_trace->p_samples[i];
+        uint8_t * p_dest = p_out ? p_out + total : scratch;
+
+        if (!stream_encoder_empty(&encoder) &&
+            p_sample->ticks - frame_start >= m_flush_interval_ticks)
+        {
+            total += stream_encoder_finish(&encoder, p_dest);
+            p_dest = p_out ? p_out + total : scratch;
+        }
+        if (stream_encoder_empty(&encoder)) {
+            frame_start = p_sample->ticks;
+        }
+        if (!stream_encoder_put(&encoder, p_sample->stream, p_sample->ticks, p_sample->seq, p_sample->values)) {
+            total += stream_encoder_finish(&encoder, p_dest);
+            p_dest = p_out ? p_out + total : scratch;
+            frame_start = p_sample->ticks;
+            stream_encoder_put(&encoder, p_sample->stream, p_sample->ticks, p_sample->seq, p_sample->values);
+        }
+        if (stream_encoder_full(&encoder)) {
+            total += stream_encoder_finish(&encoder, p_dest);
+        }
+    }
+    total += stream_encoder_finish(&encoder, p_out ? p_out + total : scratch);
+    return total;
+}
+
+static void verify_sample(void * p_context, stream_id_t stream, uint64_t ticks,
+                          uint16_t seq, const int32_t * p_values, uint8_t count)
+{
+    verify_ctx_t * p_ctx = p_context;
+    const trace_t * p_trace = p_ctx->p_trace;
+    size_t i = p_ctx->next[stream];
+    while (i < p_trace->count && p_trace->p_samples[i].stream != stream) {
+        ++i;
+    }
+    if (i == p_trace->count || p_trace->p_samples[i].ticks != ticks || p_trace->p_samples[i].seq != seq ||
+        memcmp(p_trace->p_samples[i].values, p_values, count * sizeof(int32_t)) != 0)
+    {
+        ++p_ctx->mismatches;
+    }
+    p_ctx->next[stream] = i + 1;
+    ++p_ctx->decoded;
+}
+
+static size_t verify(const trace_t * p_trace, uint8_t * p_data, size_t len, size_t * p_frames)
+{
+    verify_ctx_t ctx = { .p_trace = p_trace };
+    size_t start = 0;
+    *p_frames = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (p_data[i] != STREAM_FRAME_DELIMITER) {
+            continue;
+        }
+        stream_frame_t frame;
+        if (i > start && stream_frame_decode(&p_data[start], i - start, &frame)) {
+            ++*p_frames;
+            if (!stream_samples_decode(&frame, verify_sample, &ctx)) {
+                ++ctx.mismatches;
+            }
+        }
+        start = i + 1;
+    }
+    if (ctx.decoded != p_trace->count) {
+        ++ctx.mismatches;
+    }
+    return ctx.mismatches;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int bench(const char * p_path)
+{
+    trace_t trace;
+    if (trace_load(p_path, &trace) != 0 || trace.count == 0) {
+        return -1;
+    }
+
+    size_t text = 0;
+    size_t fixed = 0;
+    for (size_t i = 0; i < trace.count; ++i) {
+        text += text_bytes(&trace.p_samples[i]);
+        fixed += 1 + 4 + 2 * stream_value_count(trace.p_samples[i].stream);
+    }
+
+    uint8_t * p_encoded = malloc(trace.count * STREAM_FRAME_MAX_ENCODED);
+    size_t compressed = encode_trace(&trace, p_encoded);
+    if (mp_capture != NULL) {
+        fwrite(p_encoded, 1, compressed, mp_capture);
+    }
+    size_t frames;
+    size_t mismatches = verify(&trace, p_encoded, compressed, &frames);
+
+    volatile size_t sink = 0;
+    double start = now_ns();
+    for (int r = 0; r < TIMING_REPEATS; ++r) {
+        sink += encode_trace(&trace, NULL);
+    }
+    double ns_per_sample = (now_ns() - start) / ((double)TIMING_REPEATS * trace.count);
+
+    printf("%s (flush every %llu ms)\n", p_path,
+           (unsigned long long)(m_flush_interval_ticks * 1000 / 32768));
+    printf("  samples           %zu in %zu frames\n", trace.count, frames);
+    printf("  text output       %8zu bytes  %6.2f B/sample\n", text, (double)text / trace.count);
+    printf("  fixed binary      %8zu bytes  %6.2f B/sample (32 bit time, no framing)\n", fixed, (double)fixed / trace.count);
+    printf("  compressed        %8zu bytes  %6.2f B/sample\n", compressed, (double)compressed / trace.count);
+    printf("  ratio vs text     %8.2f x\n", (double)text / compressed);
+    printf("  ratio vs binary   %8.2f x\n", (double)fixed / compressed);
+    printf("  encode cost       %8.1f ns/sample (host)\n", ns_per_sample);
+    printf("  round trip        %s\n", mismatches ? "FAILED" : "ok");
+
+    free(p_encoded);
+    trace_free(&trace);
+    return mismatches ? -1 : 0;
+}
+
+int main(int argc, char ** argv)
+{
+    int result = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:w:")) != -1) {
+        if (opt == 'i') {
+            m_flush_interval_ticks = strtoull(optarg, NULL, 10) * 32768 / 1000;
+        }
+        else if (opt == 'w') {
+            mp_capture = fopen(optarg, "ab");
+            if (mp_capture == NULL) {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+        }
+        else {
+            fprintf(stderr, "usage: %s [-i flush_interval_ms] [-w capture] [trace.csv ...]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind == argc) {
+        result = bench("traces/office_20min.csv");
+    }
+    for (int i = optind; i < argc; ++i) {
+        result |= bench(argv[i]);
+    }
+    if (mp_capture != NULL) {
+        fclose(mp_capture);
+    }
+    return result ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,409 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "column_store.h"
+
+#define SEGMENT_SIZE            (sizeof(column_segment_header_t) + COLUMN_SEGMENT_BLOCKS * sizeof(column_block_t))
+
+static_assert(sizeof(column_block_header_t) == 64, "block header layout");
+static_assert(sizeof(column_segment_header_t) == 64, "segment header layout");
+
+static char * path_join(const char * p_dir, const char * p_name)
+{
+    char * p_path;
+    if (asprintf(&p_path, "%s/%s", p_dir, p_name) < 0) {
+        return NULL;
+    }
+    return p_path;
+}
+
+static char * segment_path(const column_channel_t * p_channel, size_t index)
+{
+    char * p_path;
+    if (asprintf(&p_path, "%s/%06zu.col", p_channel->p_dir, index) < 0) {
+        return NULL;
+    }
+    return p_path;
+}
+
+static int segment_map(column_channel_t * p_channel, size_t index, bool create)
+{
+    char * p_path = segment_path(p_channel, index);
+    int flags = p_channel->writable ? O_RDWR : O_RDONLY;
+    int fd = open(p_path, flags | (create ? O_CREAT | O_EXCL : 0) | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        if (!(errno == ENOENT && !create)) {
+            perror(p_path);
+        }
+        free(p_path);
+        return -1;
+    }
+    if (create && ftruncate(fd, SEGMENT_SIZE) != 0) {
+        perror(p_path);
+        close(fd);
+        free(p_path);
+        return -1;
+    }
+
+    struct stat st;
+    fstat(fd, &st);
+    if ((size_t)st.st_size != SEGMENT_SIZE) {
+        fprintf(stderr, "%s: wrong size for a segment\n", p_path);
+        close(fd);
+        free(p_path);
+        return -1;
+    }
+    int prot = PROT_READ | (p_channel->writable ? PROT_WRITE : 0);
+    uint8_t * p_map = mmap(NULL, SEGMENT_SIZE, prot, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        perror(p_path);
+        free(p_path);
+        return -1;
+    }
+
+    column_segment_header_t * p_header = (column_segment_header_t *)p_map;
+    if (create) {
+        memcpy(p_header->magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC) - 1);
+        p_header->magic[sizeof(p_header->magic) - 1] = COLUMN_VERSION;
+        memcpy(p_header->channel, p_channel->name, sizeof(p_header->channel));
+        p_header->block_samples = COLUMN_BLOCK_SAMPLES;
+        p_header->segment_blocks = COLUMN_SEGMENT_BLOCKS;
+    }
+    else if (memcmp(p_header->magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC) - 1) != 0 ||
+             p_header->magic[sizeof(p_header->magic) - 1] != COLUMN_VERSION ||
+             p_header->block_samples != COLUMN_BLOCK_SAMPLES ||
+             p_header->segment_blocks != COLUMN_SEGMENT_BLOCKS ||
+             p_header->blocks > COLUMN_SEGMENT_BLOCKS)
+    {
+        fprintf(stderr, "%s: not a segment of this format\n", p_path);
+        munmap(p_map, SEGMENT_SIZE);
+        free(p_path);
+        return -1;
+    }
+    free(p_path);
+
+    column_segment_t * p_segments = realloc(p_channel->p_segments,
+                                            (p_channel->segment_count + 1) * sizeof(column_segment_t));
+    p_channel->p_segments = p_segments;
+    p_segments[p_channel->segment_count++] = (column_segment_t) {
+        .p_header = p_header,
+        .p_blocks = (column_block_t *)(p_map + sizeof(column_segment_header_t)),
+        .size     = SEGMENT_SIZE,
+    };
+    return 0;
+}
+
+static int channel_open(column_store_t * p_store, const char * p_name, bool create)
+{
+    if (p_store->channel_count == COLUMN_MAX_CHANNELS || strlen(p_name) >= COLUMN_NAME_MAX) {
+        fprintf(stderr, "%s: too many channels or name too long\n", p_name);
+        return -1;
+    }
+    column_channel_t * p_channel = &p_store->channels[p_store->channel_count];
+    memset(p_channel, 0, sizeof(*p_channel));
+    strcpy(p_channel->name, p_name);
+    p_channel->p_dir = path_join(p_store->p_root, p_name);
+    p_channel->writable = p_store->writable;
+    if (create && mkdir(p_channel->p_dir, 0755) != 0 && errno != EEXIST) {
+        perror(p_channel->p_dir);
+        free(p_channel->p_dir);
+        return -1;
+    }
+    while (segment_map(p_channel, p_channel->segment_count, false) == 0) {
+    }
+    ++p_store->channel_count;
+    return 0;
+}
+
+int column_store_open(column_store_t * p_store, const char * p_root, bool writable)
+{
+    memset(p_store, 0, sizeof(*p_store));
+    if (writable && mkdir(p_root, 0755) != 0 && errno != EEXIST) {
+        perror(p_root);
+        return -1;
+    }
+    DIR * p_dir = opendir(p_root);
+    if (p_dir == NULL) {
+        perror(p_root);
+        return -1;
+    }
+    p_store->p_root = strdup(p_root);
+    p_store->writable = writable;
+
+    struct dirent * p_entry;
+    while ((p_entry = readdir(p_dir)) != NULL) {
+        if (p_entry->d_name[0] != '.' && p_entry->d_type == DT_DIR) {
+            channel_open(p_store, p_entry->d_name, false);
+        }
+    }
+    closedir(p_dir);
+    return 0;
+}
+
+void column_store_close(column_store_t * p_store)
+{
+    for (size_t c = 0; c < p_store->channel_count; ++c) {
+        column_channel_t * p_channel = &p_store->channels[c];
+        for (size_t s = 0; s < p_channel->segment_count; ++s) {
+            if (p_channel->writable) {
+                msync(p_channel->p_segments[s].p_header, SEGMENT_SIZE, MS_SYNC);
+            }
+            munmap(p_channel->p_segments[s].p_header, SEGMENT_SIZE);
+        }
+        free(p_channel->p_segments);
+        free(p_channel->p_dir);
+    }
+    free(p_store->p_root);
+    memset(p_store, 0, sizeof(*p_store));
+}
+
+column_channel_t * column_store_channel(column_store_t * p_store, const char * p_name, bool create)
+{
+    for (size_t c = 0; c < p_store->channel_count; ++c) {
+        if (strcmp(p_store->channels[c].name, p_name) == 0) {
+            return &p_store->channels[c];
+        }
+    }
+    if (!create || !p_store->writable || channel_open(p_store, p_name, true) != 0) {
+        return NULL;
+    }
+    return &p_store->channels[p_store->channel_count - 1];
+}
+
+/**@brief Last block in use, or NULL for an empty channel. */
+static const column_block_t * last_block(const column_channel_t * p_channel)
+{
+    if (p_channel->segment_count == 0) {
+        return NULL;
+    }
+    const column_segment_t * p_segment = &p_channel->p_segments[p_channel->segment_count - 1];
+    uint32_t blocks = p_segment->p_header->blocks;
+    return blocks ? &p_segment->p_blocks[blocks - 1] : NULL;
+}
+
+int column_append(column_channel_t * p_channel, int64_t t, int32_t v)
+{
+    column_block_t * p_block = (column_block_t *)last_block(p_channel);
+    if (p_block != NULL && p_block->header.count > 0 && t < p_block->header.t_max) {
+        fprintf(stderr, "%s: sample out of time order\n", p_channel->name);
+        return -1;
+    }
+
+    if (p_block == NULL || p_block->header.count == COLUMN_BLOCK_SAMPLES) {
+        column_segment_t * p_segment = p_channel->segment_count
+                                     ? &p_channel->p_segments[p_channel->segment_count - 1] : NULL;
+        if (p_segment == NULL || p_segment->p_header->blocks == COLUMN_SEGMENT_BLOCKS) {
+            if (segment_map(p_channel, p_channel->segment_count, true) != 0) {
+                return -1;
+            }
+            p_segment = &p_channel->p_segments[p_channel->segment_count - 1];
+        }
+        p_block = &p_segment->p_blocks[p_segment->p_header->blocks];
+        ++p_segment->p_header->blocks;
+    }
+
+    column_block_header_t * p_header = &p_block->header;
+    if (p_header->count == 0) {
+        p_header->t_min = t;
+        p_header->v_min = v;
+        p_header->v_max = v;
+        p_header->v_sum = 0;
+    }
+    p_block->t[p_header->count] = t;
+    p_block->v[p_header->count] = v;
+    p_header->t_max = t;
+    p_header->v_min = (v < p_header->v_min) ? v : p_header->v_min;
+    p_header->v_max = (v > p_header->v_max) ? v : p_header->v_max;
+    p_header->v_sum += v;
+    __atomic_store_n(&p_header->count, p_header->count + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+uint64_t column_count(const column_channel_t * p_channel)
+{
+    uint64_t count = 0;
+    for (size_t s = 0; s < p_channel->segment_count; ++s) {
+        const column_segment_t * p_segment = &p_channel->p_segments[s];
+        uint32_t blocks = p_segment->p_header->blocks;
+        if (blocks > 0) {
+            count += (uint64_t)(blocks - 1) * COLUMN_BLOCK_SAMPLES
+                   + p_segment->p_blocks[blocks - 1].header.count;
+        }
+    }
+    return count;
+}
+
+bool column_time_range(const column_channel_t * p_channel, int64_t * p_first, int64_t * p_last)
+{
+    const column_block_t * p_last_block = last_block(p_channel);
+    if (p_last_block == NULL || p_last_block->header.count == 0) {
+        return false;
+    }
+    *p_first = p_channel->p_segments[0].p_blocks[0].header.t_min;
+    *p_last = p_last_block->header.t_max;
+    return true;
+}
+
+/**@brief Walk the blocks that may hold samples in [t0, t1), skipping whole segments by time. */
+typedef bool (* block_visitor_t)(void * p_context, const column_block_t * p_block, uint32_t count);
+
+static void blocks_in_range(const column_channel_t * p_channel, int64_t t0, int64_t t1,
+                            block_visitor_t visitor, void * p_context)
+{
+    for (size_t s = 0; s < p_channel->segment_count; ++s) {
+        const column_segment_t * p_segment = &p_channel->p_segments[s];
+        uint32_t blocks = p_segment->p_header->blocks;
+        if (blocks == 0 || p_segment->p_blocks[blocks - 1].header.t_max < t0) {
+            continue;
+        }
+
+        // First block whose t_max reaches t0
+        uint32_t lo = 0;
+        uint32_t hi = blocks - 1;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if (p_segment->p_blocks[mid].header.t_max < t0) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        for (uint32_t b = lo; b < blocks; ++b) {
+            const column_block_t * p_block = &p_segment->p_blocks[b];
+            uint32_t count = __atomic_load_n(&p_block->header.count, __ATOMIC_ACQUIRE);
+            if (count == 0 || p_block->header.t_min >= t1) {
+                return;
+            }
+            if (!visitor(p_context, p_block, count)) {
+                return;
+            }
+        }
+    }
+}
+
+typedef struct
+{
+    int64_t             t0;
+    int64_t             t1;
+    column_sample_handler_t handler;
+    void                *p_context;
+    uint64_t            visited;
+} scan_ctx_t;
+
+static bool scan_block(void * p_context, const column_block_t * p_block, uint32_t count)
+{
+    scan_ctx_t * p_ctx = p_context;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (p_block->t[i] >= p_ctx->t1) {
+            return false;
+        }
+        if (p_block->t[i] >= p_ctx->t0) {
+            p_ctx->handler(p_ctx->p_context, p_block->t[i], p_block->v[i]);
+            ++p_ctx->visited;
+        }
+    }
+    return true;
+}
+
+uint64_t column_scan(const column_channel_t * p_channel, int64_t t0, int64_t t1,
+                     column_sample_handler_t handler, void * p_context)
+{
+    scan_ctx_t ctx = { .t0 = t0, .t1 = t1, .handler = handler, .p_context = p_context };
+    blocks_in_range(p_channel, t0, t1, scan_block, &ctx);
+    return ctx.visited;
+}
+
+typedef struct
+{
+    int64_t             t0;
+    int64_t             t1;
+    int64_t             width;
+    column_bucket_t     *p_buckets;
+    size_t              count;
+} query_ctx_t;
+
+static void bucket_add(column_bucket_t * p_bucket, uint64_t count, int32_t min, int32_t max, int64_t sum)
+{
+    if (p_bucket->count == 0 || min < p_bucket->min) {
+        p_bucket->min = min;
+    }
+    if (p_bucket->count == 0 || max > p_bucket->max) {
+        p_bucket->max = max;
+    }
+    p_bucket->count += count;
+    p_bucket->sum += sum;
+}
+
+static bool query_block(void * p_context, const column_block_t * p_block, uint32_t count)
+{
+    query_ctx_t * p_ctx = p_context;
+    const column_block_header_t * p_header = &p_block->header;
+
+    // A complete block inside one bucket needs only its header
+    if (count == COLUMN_BLOCK_SAMPLES && p_header->t_min >= p_ctx->t0 && p_header->t_max < p_ctx->t1) {
+        size_t first = (p_header->t_min - p_ctx->t0) / p_ctx->width;
+        size_t last = (p_header->t_max - p_ctx->t0) / p_ctx->width;
+        if (first == last && first < p_ctx->count) {
+            bucket_add(&p_ctx->p_buckets[first], count, p_header->v_min, p_header->v_max, p_header->v_sum);
+            return true;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        int64_t t = p_block->t[i];
+        if (t >= p_ctx->t1) {
+            return false;
+        }
+        if (t >= p_ctx->t0) {
+            size_t index = (t - p_ctx->t0) / p_ctx->width;
+            if (index < p_ctx->count) {
+                bucket_add(&p_ctx->p_buckets[index], 1, p_block->v[i], p_block->v[i], p_block->v[i]);
+            }
+        }
+    }
+    return true;
+}
+
+void column_query(const column_channel_t * p_channel, int64_t t0, int64_t t1,
+                  column_bucket_t * p_buckets, size_t count)
+{
+    query_ctx_t ctx = {
+        .t0        = t0,
+        .t1        = t1,
+        .width     = (t1 - t0 + (int64_t)count - 1) / (int64_t)count,
+        .p_buckets = p_buckets,
+        .count     = count,
+    };
+    if (ctx.width <= 0) {
+        ctx.width = 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        p_buckets[i] = (column_bucket_t) { .t_start = t0 + (int64_t)i * ctx.width };
+    }
+    blocks_in_range(p_channel, t0, t1, query_block, &ctx);
+}
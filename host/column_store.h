@@ -0,0 +1,160 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+/**@file
+ *
+ * @brief    Append-only, memory mapped columnar store for captured samples.
+ *
+ * @details  A store is a directory with one subdirectory per channel (one sensor value, e.g.
+ *           "temp.ir"). A channel is a sequence of fixed-size segment files, 000000.col,
+ *           000001.col, ..., each mapped whole. A segment is a header followed by
+ *           COLUMN_SEGMENT_BLOCKS blocks, and a block is a fixed header followed by a
+ *           timestamp column and a value column of COLUMN_BLOCK_SAMPLES entries:
+ *
+ *               segment: column_segment_header_t | column_block_t * COLUMN_SEGMENT_BLOCKS
+ *               block:   count | t_min | t_max | v_min | v_max | v_sum | t[] | v[]
+ *
+ *           Timestamps are host nanoseconds since the epoch and never decrease within a
+ *           channel, so a time range is found by binary search on the block headers, and a
+ *           downsampling query that covers a whole block uses its header without touching the
+ *           columns. Values are the raw sensor words; sensortag_payload.h scales them.
+ *
+ *           Files are in host byte order. A block's count is only raised after its columns are
+ *           written, so a reader mapping a channel that is being appended sees whole samples.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define COLUMN_MAGIC                "STCOL\0\0"
+#define COLUMN_VERSION              1
+#define COLUMN_BLOCK_SAMPLES        1024
+#define COLUMN_SEGMENT_BLOCKS       256
+#define COLUMN_NAME_MAX             32
+#define COLUMN_MAX_CHANNELS         16
+
+typedef struct
+{
+    uint32_t            count;
+    uint32_t            reserved;
+    int64_t             t_min;
+    int64_t             t_max;
+    int32_t             v_min;
+    int32_t             v_max;
+    int64_t             v_sum;
+    uint8_t             pad[24];
+} column_block_header_t;
+
+typedef struct
+{
+    column_block_header_t header;
+    int64_t             t[COLUMN_BLOCK_SAMPLES];
+    int32_t             v[COLUMN_BLOCK_SAMPLES];
+} column_block_t;
+
+typedef struct
+{
+    char                magic[8];               // COLUMN_MAGIC, then COLUMN_VERSION in the last byte
+    char                channel[COLUMN_NAME_MAX];
+    uint32_t            block_samples;
+    uint32_t            segment_blocks;
+    uint32_t            blocks;                 // Blocks in use; only the last can be partly filled
+    uint8_t             pad[12];
+} column_segment_header_t;
+
+typedef struct
+{
+    column_segment_header_t *p_header;
+    column_block_t      *p_blocks;
+    size_t              size;
+} column_segment_t;
+
+typedef struct
+{
+    char                name[COLUMN_NAME_MAX];
+    char                *p_dir;
+    column_segment_t    *p_segments;
+    size_t              segment_count;
+    bool                writable;
+} column_channel_t;
+
+typedef struct
+{
+    char                *p_root;
+    bool                writable;
+    column_channel_t    channels[COLUMN_MAX_CHANNELS];
+    size_t              channel_count;
+} column_store_t;
+
+/**@brief One downsampling bucket: samples with t_start <= t < t_start + width. */
+typedef struct
+{
+    int64_t             t_start;
+    uint64_t            count;
+    int32_t             min;
+    int32_t             max;
+    int64_t             sum;
+} column_bucket_t;
+
+/**@brief   Callback for each sample returned by column_scan. */
+typedef void (* column_sample_handler_t)(void * p_context, int64_t t, int32_t v);
+
+/**@brief   Open a store and map its channels. A writable store is created if it is missing.
+ *
+ * @return  0 on success, -1 with a message on stderr.
+ */
+int column_store_open(column_store_t * p_store, const char * p_root, bool writable);
+
+/**@brief   Flush and unmap everything. */
+void column_store_close(column_store_t * p_store);
+
+/**@brief   Channel with the given name; created if requested and the store is writable.
+ *
+ * @return  The channel, or NULL.
+ */
+column_channel_t * column_store_channel(column_store_t * p_store, const char * p_name, bool create);
+
+/**@brief   Append a sample. t must not be less than column_last_time().
+ *
+ * @return  0 on success, -1 with a message on stderr.
+ */
+int column_append(column_channel_t * p_channel, int64_t t, int32_t v);
+
+/**@brief   Number of samples in a channel. */
+uint64_t column_count(const column_channel_t * p_channel);
+
+/**@brief   Time range of a channel. Returns false if it is empty. */
+bool column_time_range(const column_channel_t * p_channel, int64_t * p_first, int64_t * p_last);
+
+/**@brief   Call handler for every sample with t0 <= t < t1, in time order.
+ *
+ * @return  Number of samples visited.
+ */
+uint64_t column_scan(const column_channel_t * p_channel, int64_t t0, int64_t t1,
+                     column_sample_handler_t handler, void * p_context);
+
+/**@brief   Downsample [t0, t1) into count equal buckets of min, max, sum and count.
+ *
+ * @details A block that falls entirely into one bucket contributes its header; only blocks
+ *          that straddle a bucket boundary or the range ends are scanned.
+ */
+void column_query(const column_channel_t * p_channel, int64_t t0, int64_t t1,
+                  column_bucket_t * p_buckets, size_t count);
+
+#endif // COLUMN_STORE_H
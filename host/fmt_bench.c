@@ -0,0 +1,229 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Cost of the text output mode: the firmware's fmt_support.c against printf.
+ *
+ * @details  Formats every sample of the traces as a text line twice, the way output_support.c
+ *           does with fmt_support.c and the way it did with snprintf and %3.2f, and reports the
+ *           bytes per second and the time per line of each. The cycle counts are the host's
+ *           (TSC on x86), so only the ratio carries over to the Cortex-M0.
+ *
+ *           Every line must come out byte for byte the same both ways. So must every
+ *           temperature word from -32768 to 32767, and a set of edge values for the other
+ *           fmt_support functions.
+ *
+ *           usage: fmt_bench [trace.csv ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()                __rdtsc()
+#else
+#define CYCLES()                0
+#endif
+
+#include "fmt_support.h"
+#include "trace.h"
+
+#define LINE_MAX                80                              /**< Matches OUTPUT_LINE_MAX */
+#define TEMP_FRAC_BITS          7                               /**< Matches OUTPUT_TEMP_FRAC_BITS */
+#define TIMING_REPEATS          200
+
+typedef size_t (* line_formatter_t)(char * p_line, const trace_sample_t * p_sample);
+
+/**@brief The text line as output_support.c wrote it with snprintf, float temperatures included. */
+static size_t printf_line(char * p_line, const trace_sample_t * p_sample)
+{
+    uint64_t ms = p_sample->ticks * 1000 / 32768;
+    int len = snprintf(p_line, LINE_MAX, "[%lu.%03lu] #%u ",
+                       (unsigned long)(ms / 1000), (unsigned long)(ms % 1000), p_sample->seq);
+    if (p_sample->stream == STREAM_LUXO) {
+        len += snprintf(&p_line[len], LINE_MAX - len, "Lux value: %i\n", (uint16_t)p_sample->values[0]);
+    }
+    else {
+        len += snprintf(&p_line[len], LINE_MAX - len, "IR Temp: %3.2f\t Ambient Temp: %3.2f\n",
+                        0.0078125f * p_sample->values[0], 0.0078125f * p_sample->values[1]);
+    }
+    return len;
+}
+
+/**@brief The text line as output_support.c writes it with fmt_support.c. */
+static size_t fmt_line(char * p_line, const trace_sample_t * p_sample)
+{
+    uint64_t ms = p_sample->ticks * 1000 / 32768;
+    fmt_t line;
+
+    fmt_init(&line, p_line, LINE_MAX);
+    fmt_char(&line, '[');
+    fmt_uint(&line, (uint32_t)(ms / 1000), 0);
+    fmt_char(&line, '.');
+    fmt_uint(&line, (uint32_t)(ms % 1000), 3);
+    fmt_str(&line, "] #");
+    fmt_uint(&line, p_sample->seq, 0);
+    fmt_char(&line, ' ');
+    if (p_sample->stream == STREAM_LUXO) {
+        fmt_str(&line, "Lux value: ");
+        fmt_int(&line, (uint16_t)p_sample->values[0]);
+    }
+    else {
+        fmt_str(&line, "IR Temp: ");
+        fmt_fixed(&line, p_sample->values[0], TEMP_FRAC_BITS, 2);
+        fmt_str(&line, "\t Ambient Temp: ");
+        fmt_fixed(&line, p_sample->values[1], TEMP_FRAC_BITS, 2);
+    }
+    fmt_char(&line, '\n');
+    return line.len;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**@brief Compare one formatted piece against its printf equivalent. */
+static size_t check(const fmt_t * p_fmt, const char * p_expected)
+{
+    if (p_fmt->len != strlen(p_expected) || memcmp(p_fmt->p_buf, p_expected, p_fmt->len) != 0) {
+        fprintf(stderr, "  mismatch: \"%.*s\" instead of \"%s\"\n", p_fmt->len, p_fmt->p_buf, p_expected);
+        return 1;
+    }
+    return 0;
+}
+
+/**@brief Every temperature word, and edge values of the other formats, against printf. */
+static size_t check_formats(void)
+{
+    static const int32_t ints[] = { 0, 1, -1, 9, 10, -10, 65535, INT32_MAX, INT32_MIN };
+    static const uint32_t hexes[] = { 0, 0xF, 0x10, 0x20000000, 0xFFFFFFFF };
+    char buf[LINE_MAX];
+    char expected[LINE_MAX];
+    fmt_t line;
+    size_t mismatches = 0;
+
+    for (int32_t raw = INT16_MIN; raw <= INT16_MAX; ++raw) {
+        fmt_init(&line, buf, sizeof(buf));
+        fmt_fixed(&line, raw, TEMP_FRAC_BITS, 2);
+        snprintf(expected, sizeof(expected), "%3.2f", 0.0078125f * raw);
+        mismatches += check(&line, expected);
+    }
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); ++i) {
+        fmt_init(&line, buf, sizeof(buf));
+        fmt_int(&line, ints[i]);
+        snprintf(expected, sizeof(expected), "%li", (long)ints[i]);
+        mismatches += check(&line, expected);
+
+        for (uint8_t digits = 0; digits <= FMT_FIXED_MAX_DIGITS; ++digits) {
+            fmt_init(&line, buf, sizeof(buf));
+            fmt_fixed(&line, ints[i] / 65536, 4, digits);
+            snprintf(expected, sizeof(expected), "%.*f", digits, (ints[i] / 65536) / 16.0);
+            mismatches += check(&line, expected);
+        }
+    }
+    for (size_t i = 0; i < sizeof(hexes) / sizeof(hexes[0]); ++i) {
+        fmt_init(&line, buf, sizeof(buf));
+        fmt_uint(&line, hexes[i], 3);
+        fmt_char(&line, ' ');
+        fmt_hex(&line, hexes[i], 8);
+        snprintf(expected, sizeof(expected), "%03lu %08lx", (unsigned long)hexes[i], (unsigned long)hexes[i]);
+        mismatches += check(&line, expected);
+    }
+    return mismatches;
+}
+
+/**@brief Format the whole trace repeatedly; returns ns and cycles per line, and the bytes per pass. */
+static size_t time_lines(const trace_t * p_trace, line_formatter_t formatter,
+                         double * p_ns, double * p_cycles)
+{
+    char line[LINE_MAX];
+    volatile size_t sink = 0;
+    size_t bytes = 0;
+
+    double start = now_ns();
+    uint64_t start_cycles = CYCLES();
+    for (int r = 0; r < TIMING_REPEATS; ++r) {
+        bytes = 0;
+        for (size_t i = 0; i < p_trace->count; ++i) {
+            bytes += formatter(line, &p_trace->p_samples[i]);
+            sink += line[0];
+        }
+    }
+    double lines = (double)TIMING_REPEATS * p_trace->count;
+    *p_cycles = (CYCLES() - start_cycles) / lines;
+    *p_ns = (now_ns() - start) / lines;
+    return bytes;
+}
+
+static int bench(const char * p_path)
+{
+    trace_t trace;
+    if (trace_load(p_path, &trace) != 0 || trace.count == 0) {
+        return -1;
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < trace.count; ++i) {
+        char expected[LINE_MAX];
+        char buf[LINE_MAX];
+        fmt_t line = { .p_buf = buf, .size = sizeof(buf) };
+        size_t len = printf_line(expected, &trace.p_samples[i]);
+        line.len = fmt_line(buf, &trace.p_samples[i]);
+        expected[len] = '\0';
+        mismatches += check(&line, expected);
+    }
+
+    double printf_ns, printf_cycles, fmt_ns, fmt_cycles;
+    size_t bytes = time_lines(&trace, printf_line, &printf_ns, &printf_cycles);
+    time_lines(&trace, fmt_line, &fmt_ns, &fmt_cycles);
+    double line_bytes = (double)bytes / trace.count;
+
+    printf("%s\n", p_path);
+    printf("  lines             %zu, %.1f bytes each\n", trace.count, line_bytes);
+    printf("  snprintf %%f       %8.1f ns/line  %8.0f cycles/line  %7.1f MB/s (host)\n",
+           printf_ns, printf_cycles, line_bytes * 1e3 / printf_ns);
+    printf("  fmt_support       %8.1f ns/line  %8.0f cycles/line  %7.1f MB/s (host)\n",
+           fmt_ns, fmt_cycles, line_bytes * 1e3 / fmt_ns);
+    printf("  speedup           %8.2f x\n", printf_ns / fmt_ns);
+    printf("  same output       %s\n", mismatches ? "FAILED" : "ok");
+
+    trace_free(&trace);
+    return mismatches ? -1 : 0;
+}
+
+int main(int argc, char ** argv)
+{
+    int result = 0;
+
+    size_t mismatches = check_formats();
+    printf("formats             %s\n", mismatches ? "FAILED" : "ok");
+    if (mismatches) {
+        result = -1;
+    }
+    if (argc < 2) {
+        result |= bench("traces/office_20min.csv");
+    }
+    for (int i = 1; i < argc; ++i) {
+        result |= bench(argv[i]);
+    }
+    return result ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef FUZZ_H
+#define FUZZ_H
+
+/**@file
+ *
+ * @brief    Shared declarations of the fuzz targets.
+ *
+ * @details  Every target defines LLVMFuzzerTestOneInput. Built with clang -fsanitize=fuzzer it
+ *           runs under libFuzzer; built with fuzz_driver.c it replays a corpus and applies
+ *           simple random mutations, which also makes it usable as an AFL target.
+ *           FUZZ_CHECK aborts on a broken invariant, so a wrong result is reported like a crash.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FUZZ_CHECK(cond)                                                            \
+do                                                                                  \
+{                                                                                   \
+    if (!(cond))                                                                    \
+    {                                                                               \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+        abort();                                                                    \
+    }                                                                               \
+} while (0)
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t size);
+
+#endif // FUZZ_H
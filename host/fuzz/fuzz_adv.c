@@ -0,0 +1,46 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Fuzz target: advertising reports, as scan_support.c's is_uuid_present walks them.
+ *
+ * @details  The input is the report's data. Every field returned must lie inside it.
+ */
+
+#include <string.h>
+
+#include "fuzz.h"
+#include "adv_parser.h"
+
+#define ST_MVMT_SERVICE         0xaa80                          /**< BLE_UUID_ST_MVMT_SERVICE */
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t size)
+{
+    if (size > UINT16_MAX) {
+        return 0;
+    }
+    uint16_t offset = 0;
+    adv_field_t field;
+    while (adv_field_next(p_data, (uint16_t)size, &offset, &field)) {
+        FUZZ_CHECK(field.p_data >= p_data + 2);
+        FUZZ_CHECK(field.p_data + field.len <= p_data + size);
+        FUZZ_CHECK(offset <= size);
+        if (adv_field_has_uuid16(&field, ST_MVMT_SERVICE)) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Fuzz target: encode and decode round trip of the output stream.
+ *
+ * @details  The input is a list of 7 byte samples: stream and flags, tick advance, and two
+ *           16 bit values that the flags can widen. The flags can also skip sequence numbers. The samples go through the firmware's
+ *           encoder, every frame is decoded again, and each stream must come back exactly.
+ *           Alerts, log messages and counters built from the same bytes must survive their own
+ *           round trips.
+ */
+
+#include <string.h>
+
+#include "fuzz.h"
+#include "stream_codec.h"
+
+#define MAX_SAMPLES             512
+
+typedef struct
+{
+    uint64_t            ticks;
+    uint16_t            seq;
+    int32_t             values[STREAM_MAX_VALUES];
+} sample_t;
+
+typedef struct
+{
+    sample_t            sent[STREAM_COUNT][MAX_SAMPLES];
+    size_t              sent_count[STREAM_COUNT];
+    size_t              received[STREAM_COUNT];
+    uint16_t            next_seq[STREAM_COUNT];
+} round_trip_t;
+
+static void on_sample(void * p_context, stream_id_t stream, uint64_t ticks,
+                      uint16_t seq, const int32_t * p_values, uint8_t count)
+{
+    round_trip_t * p_rt = p_context;
+    FUZZ_CHECK(stream < STREAM_COUNT);
+    size_t i = p_rt->received[stream]++;
+    FUZZ_CHECK(i < p_rt->sent_count[stream]);
+    FUZZ_CHECK(p_rt->sent[stream][i].ticks == ticks);
+    FUZZ_CHECK(p_rt->sent[stream][i].seq == seq);
+    FUZZ_CHECK(memcmp(p_rt->sent[stream][i].values, p_values, count * sizeof(int32_t)) == 0);
+}
+
+static void check_frame(round_trip_t * p_rt, uint8_t * p_out, uint16_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    FUZZ_CHECK(len <= STREAM_FRAME_MAX_ENCODED);
+    FUZZ_CHECK(p_out[0] == STREAM_FRAME_DELIMITER && p_out[len - 1] == STREAM_FRAME_DELIMITER);
+    FUZZ_CHECK(memchr(&p_out[1], STREAM_FRAME_DELIMITER, len - 2) == NULL);
+
+    stream_frame_t frame;
+    FUZZ_CHECK(stream_frame_decode(&p_out[1], len - 2, &frame));
+    FUZZ_CHECK(frame.type == STREAM_FRAME_SAMPLES);
+    FUZZ_CHECK(stream_samples_decode(&frame, on_sample, p_rt));
+}
+
+static void check_alert(const uint8_t * p_sample)
+{
+    stream_alert_t alert = {
+        .rule_index  = p_sample[0],
+        .stream      = p_sample[1],
+        .value_index = p_sample[2] & 1,
+        .kind        = p_sample[2] >> 1,
+        .raised      = p_sample[0] & 1,
+        .value       = (int32_t)((uint32_t)p_sample[3] << 24 | p_sample[4] << 16 | p_sample[5] << 8 | p_sample[6]),
+    };
+    uint8_t out[STREAM_FRAME_MAX_ENCODED];
+    uint16_t len = stream_alert_encode(&alert, p_sample[1], out);
+    FUZZ_CHECK(len > 2 && len <= STREAM_FRAME_MAX_ENCODED);
+
+    stream_frame_t frame;
+    stream_alert_t decoded;
+    FUZZ_CHECK(stream_frame_decode(&out[1], len - 2, &frame));
+    FUZZ_CHECK(stream_alert_decode(&frame, &decoded));
+    FUZZ_CHECK(decoded.rule_index == alert.rule_index && decoded.stream == alert.stream &&
+               decoded.value_index == alert.value_index && decoded.kind == alert.kind &&
+               decoded.raised == alert.raised && decoded.value == alert.value);
+}
+
+static void check_log(const uint8_t * p_data, size_t size)
+{
+    stream_log_t log = { .count = size % (STREAM_LOG_MAX_ARGS + 1) };
+    memcpy(&log.token, p_data, size < 4 ? size : 4);
+    for (uint8_t i = 0; i < log.count && 4u * (i + 2u) <= size; ++i) {
+        memcpy(&log.args[i], &p_data[4 * (i + 1)], 4);
+    }
+    uint8_t out[STREAM_FRAME_MAX_ENCODED];
+    uint16_t len = stream_log_encode(&log, (uint8_t)size, out);
+    FUZZ_CHECK(len > 2 && len <= STREAM_FRAME_MAX_ENCODED);
+
+    stream_frame_t frame;
+    stream_log_t decoded;
+    FUZZ_CHECK(stream_frame_decode(&out[1], len - 2, &frame));
+    FUZZ_CHECK(frame.type == STREAM_FRAME_LOG && frame.frame_seq == (uint8_t)size);
+    FUZZ_CHECK(stream_log_decode(&frame, &decoded));
+    FUZZ_CHECK(decoded.token == log.token && decoded.count == log.count);
+    FUZZ_CHECK(memcmp(decoded.args, log.args, log.count * sizeof(int32_t)) == 0);
+}
+
+static void check_stats(const uint8_t * p_data, size_t size)
+{
+    uint32_t values[32];
+    uint8_t count = 0;
+    for (size_t i = 0; i + 4 <= size && count < 32; i += 4) {
+        memcpy(&values[count++], &p_data[i], 4);
+    }
+    uint8_t first = 0;
+    while (first < count) {
+        uint8_t out[STREAM_FRAME_MAX_ENCODED];
+        uint8_t encoded;
+        uint16_t len = stream_stats_encode(first, &values[first], count - first, 0, out, &encoded);
+        FUZZ_CHECK(len > 2 && len <= STREAM_FRAME_MAX_ENCODED && encoded > 0);
+
+        stream_frame_t frame;
+        uint32_t decoded[32];
+        uint8_t decoded_first;
+        uint8_t decoded_count;
+        FUZZ_CHECK(stream_frame_decode(&out[1], len - 2, &frame));
+        FUZZ_CHECK(stream_stats_decode(&frame, &decoded_first, decoded, 32, &decoded_count));
+        FUZZ_CHECK(decoded_first == first && decoded_count == encoded);
+        FUZZ_CHECK(memcmp(decoded, &values[first], encoded * sizeof(uint32_t)) == 0);
+        first += encoded;
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t size)
+{
+    static round_trip_t rt;
+    memset(&rt, 0, sizeof(rt));
+
+    stream_encoder_t encoder;
+    stream_encoder_init(&encoder);
+    uint8_t out[STREAM_FRAME_MAX_ENCODED];
+    uint64_t ticks = 0;
+
+    for (size_t i = 0; i + 7 <= size; i += 7) {
+        const uint8_t * p_sample = &p_data[i];
+        stream_id_t stream = p_sample[0] % STREAM_COUNT;
+        if (rt.sent_count[stream] == MAX_SAMPLES) {
+            break;
+        }
+        // Flags: bit 2 long tick advance, bit 3 wide values, bit 4 finish the frame afterwards,
+        // bits 5-7 skip sequence numbers (7: a long jump)
+        ticks += (p_sample[0] & 0x04) ? (uint64_t)p_sample[1] << 16 : p_sample[1];
+        uint8_t skip = p_sample[0] >> 5;
+        rt.next_seq[stream] += (skip == 7) ? (uint16_t)(p_sample[1] << 8 | p_sample[2]) : skip;
+        sample_t * p_sent = &rt.sent[stream][rt.sent_count[stream]];
+        p_sent->ticks = ticks;
+        p_sent->seq = rt.next_seq[stream]++;
+        for (uint8_t v = 0; v < STREAM_MAX_VALUES; ++v) {
+            int32_t value = (int16_t)(p_sample[2 + 2 * v] | p_sample[3 + 2 * v] << 8);
+            p_sent->values[v] = (p_sample[0] & 0x08) ? (int32_t)((uint32_t)value * 65537u) : value;
+        }
+        if (!stream_encoder_put(&encoder, stream, ticks, p_sent->seq, p_sent->values)) {
+            check_frame(&rt, out, stream_encoder_finish(&encoder, out));
+            FUZZ_CHECK(stream_encoder_put(&encoder, stream, ticks, p_sent->seq, p_sent->values));
+        }
+        ++rt.sent_count[stream];
+        if (stream_encoder_full(&encoder) || (p_sample[0] & 0x10)) {
+            check_frame(&rt, out, stream_encoder_finish(&encoder, out));
+        }
+        if (i == 0) {
+            check_alert(p_sample);
+        }
+    }
+    check_frame(&rt, out, stream_encoder_finish(&encoder, out));
+    for (int stream = 0; stream < STREAM_COUNT; ++stream) {
+        FUZZ_CHECK(rt.received[stream] == rt.sent_count[stream]);
+    }
+
+    check_stats(p_data, size);
+    check_log(p_data, size);
+    return 0;
+}
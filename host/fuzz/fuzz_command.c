@@ -0,0 +1,42 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Fuzz target: the UART and relay command line parser.
+ */
+
+#include "fuzz.h"
+#include "command_support.h"
+
+static void on_command(void * p_context, const command_t * p_command)
+{
+    size_t * p_lines = p_context;
+    ++*p_lines;
+    if (p_command != NULL) {
+        FUZZ_CHECK(p_command->count > 0 && p_command->count <= COMMAND_MAX_TOKENS);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t size)
+{
+    command_parser_t parser;
+    size_t lines = 0;
+    command_parser_init(&parser, on_command, &lines);
+    for (size_t i = 0; i < size; ++i) {
+        command_parser_put(&parser, p_data[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Standalone runner for the fuzz targets, for toolchains without libFuzzer.
+ *
+ * @details  Runs LLVMFuzzerTestOneInput on every file named, recursing into directories, and
+ *           then on random mutations of those inputs. With no arguments it reads one input
+ *           from stdin, which is what AFL expects.
+ *
+ *           usage: fuzz_<target> [-m mutations] [-s seed] [corpus ...]
+ */
+
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fuzz.h"
+
+#define FUZZ_MAX_INPUT          4096
+#define MAX_INPUTS              1024
+
+static uint8_t * m_inputs[MAX_INPUTS];
+static size_t    m_sizes[MAX_INPUTS];
+static size_t    m_count;
+
+static size_t read_all(FILE * p_file, uint8_t * p_buf)
+{
+    size_t size = 0;
+    size_t n;
+    while (size < FUZZ_MAX_INPUT && (n = fread(&p_buf[size], 1, FUZZ_MAX_INPUT - size, p_file)) > 0) {
+        size += n;
+    }
+    return size;
+}
+
+static void load(const char * p_path)
+{
+    struct stat st;
+    if (stat(p_path, &st) != 0) {
+        perror(p_path);
+        exit(1);
+    }
+    if (S_ISDIR(st.st_mode)) {
+        struct dirent ** p_entries;
+        int n = scandir(p_path, &p_entries, NULL, alphasort);
+        for (int i = 0; i < n; ++i) {
+            if (p_entries[i]->d_name[0] != '.') {
+                char path[4096];
+                snprintf(path, sizeof(path), "%s/%s", p_path, p_entries[i]->d_name);
+                load(path);
+            }
+            free(p_entries[i]);
+        }
+        free(p_entries);
+        return;
+    }
+
+    FILE * p_file = fopen(p_path, "rb");
+    if (p_file == NULL || m_count == MAX_INPUTS) {
+        fprintf(stderr, "%s: skipped\n", p_path);
+        if (p_file) {
+            fclose(p_file);
+        }
+        return;
+    }
+    uint8_t * p_buf = malloc(FUZZ_MAX_INPUT);
+    m_sizes[m_count] = read_all(p_file, p_buf);
+    m_inputs[m_count++] = p_buf;
+    fclose(p_file);
+
+    // Exact-size copy, so that ASan sees a read past the end of the input
+    uint8_t * p_copy = malloc(m_sizes[m_count - 1] ? m_sizes[m_count - 1] : 1);
+    memcpy(p_copy, p_buf, m_sizes[m_count - 1]);
+    LLVMFuzzerTestOneInput(p_copy, m_sizes[m_count - 1]);
+    free(p_copy);
+}
+
+/**@brief Bit flips, byte sets, interesting values, cuts, insertions and splices with another input. */
+static size_t mutate(uint8_t * p_buf, size_t size)
+{
+    static const uint8_t interesting[] = { 0x00, 0x01, 0x02, 0x03, 0x7f, 0x80, 0xfe, 0xff };
+    int rounds = 1 + rand() % 4;
+    while (rounds--) {
+        size_t pos = size ? (size_t)rand() % size : 0;
+        switch (rand() % 6) {
+            case 0:
+                if (size) p_buf[pos] ^= 1 << (rand() % 8);
+                break;
+            case 1:
+                if (size) p_buf[pos] = (uint8_t)rand();
+                break;
+            case 2:
+                if (size) p_buf[pos] = interesting[rand() % sizeof(interesting)];
+                break;
+            case 3:
+                size = pos;
+                break;
+            case 4:
+                if (size < FUZZ_MAX_INPUT) {
+                    memmove(&p_buf[pos + 1], &p_buf[pos], size - pos);
+                    p_buf[pos] = (uint8_t)rand();
+                    ++size;
+                }
+                break;
+            case 5:
+                if (m_count) {
+                    size_t other = (size_t)rand() % m_count;
+                    size_t from = m_sizes[other] ? (size_t)rand() % m_sizes[other] : 0;
+                    size_t n = m_sizes[other] - from;
+                    if (n > FUZZ_MAX_INPUT - pos) {
+                        n = FUZZ_MAX_INPUT - pos;
+                    }
+                    memcpy(&p_buf[pos], &m_inputs[other][from], n);
+                    size = pos + n;
+                }
+                break;
+        }
+    }
+    return size;
+}
+
+int main(int argc, char ** argv)
+{
+    long mutations = 0;
+    unsigned seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:s:")) != -1) {
+        switch (opt) {
+            case 'm': mutations = strtol(optarg, NULL, 0); break;
+            case 's': seed = (unsigned)strtoul(optarg, NULL, 0); break;
+            default:
+                fprintf(stderr, "usage: %s [-m mutations] [-s seed] [corpus ...]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind == argc) {
+        uint8_t * p_buf = malloc(FUZZ_MAX_INPUT);
+        size_t size = read_all(stdin, p_buf);
+        uint8_t * p_copy = malloc(size ? size : 1);
+        memcpy(p_copy, p_buf, size);
+        LLVMFuzzerTestOneInput(p_copy, size);
+        free(p_copy);
+        free(p_buf);
+        return 0;
+    }
+
+    for (int i = optind; i < argc; ++i) {
+        load(argv[i]);
+    }
+
+    srand(seed);
+    static uint8_t buf[FUZZ_MAX_INPUT];
+    for (long i = 0; i < mutations && m_count; ++i) {
+        size_t base = (size_t)rand() % m_count;
+        memcpy(buf, m_inputs[base], m_sizes[base]);
+        size_t size = mutate(buf, m_sizes[base]);
+        uint8_t * p_copy = malloc(size ? size : 1);
+        memcpy(p_copy, buf, size);
+        LLVMFuzzerTestOneInput(p_copy, size);
+        free(p_copy);
+    }
+    fprintf(stderr, "%s: %zu inputs, %ld mutations ok\n", argv[0], m_count, mutations);
+    return 0;
+}
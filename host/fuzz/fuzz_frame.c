@@ -0,0 +1,128 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Fuzz target: the host side of the output stream.
+ *
+ * @details  The input is tried as one frame through stream_frame_decode and the payload
+ *           decoder of its type, then as a raw UART capture through ingest_parser.c, cut into
+ *           reads at sizes taken from the input itself. Log frames are printed from a small
+ *           dictionary of awkward format strings, and with fmt_format as text mode would.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz.h"
+#include "stream_codec.h"
+#include "ingest_parser.h"
+#include "log_dict.h"
+#include "fmt_support.h"
+
+static char m_strings[] = "%d%%%5u|%-3x %08X\0\0\0\0%c%s%p%f%lu%hhd%.3d%*d%\0no arguments\0%";
+
+static void print_log(const stream_log_t * p_log)
+{
+    const log_dict_t dict = { .p_strings = m_strings, .size = sizeof(m_strings) - 1 };
+    char text[64];
+    FUZZ_CHECK(log_dict_format(&dict, p_log, text, sizeof(text)) < sizeof(text));
+    FUZZ_CHECK(strlen(text) < sizeof(text));
+
+    const char * p_format = log_dict_lookup(&dict, p_log->token);
+    if (p_format != NULL) {
+        fmt_t line;
+        fmt_init(&line, text, sizeof(text));
+        fmt_format(&line, p_format, p_log->args, p_log->count);
+        FUZZ_CHECK(line.len <= sizeof(text));
+    }
+}
+
+static void on_sample(void * p_context, stream_id_t stream, uint64_t ticks,
+                      uint16_t seq, const int32_t * p_values, uint8_t count)
+{
+    FUZZ_CHECK(stream < STREAM_COUNT);
+    FUZZ_CHECK(count == stream_value_count(stream));
+}
+
+static void on_record(void * p_context, uint8_t kind, const uint8_t * p_data, uint16_t len)
+{
+    FUZZ_CHECK(kind == INGEST_RECORD_FRAME || kind == INGEST_RECORD_TEXT);
+    FUZZ_CHECK(len <= INGEST_RECORD_MAX_DATA);
+    if (kind == INGEST_RECORD_FRAME) {
+        FUZZ_CHECK(len >= STREAM_FRAME_HEADER_LEN && len <= STREAM_FRAME_HEADER_LEN + STREAM_FRAME_MAX_PAYLOAD);
+    }
+    else {
+        FUZZ_CHECK(len > 0 && memchr(p_data, '\n', len) == NULL);
+    }
+}
+
+static void decode_frame(const uint8_t * p_data, size_t size)
+{
+    if (size == 0 || size > UINT16_MAX) {
+        return;
+    }
+    uint8_t * p_buf = malloc(size);
+    memcpy(p_buf, p_data, size);
+
+    stream_frame_t frame;
+    if (stream_frame_decode(p_buf, (uint16_t)size, &frame)) {
+        FUZZ_CHECK(frame.p_payload >= p_buf && frame.p_payload + frame.len <= p_buf + size);
+        switch (frame.type) {
+            case STREAM_FRAME_SAMPLES:
+                stream_samples_decode(&frame, on_sample, NULL);
+                break;
+            case STREAM_FRAME_ALERT:
+                stream_alert_t alert;
+                stream_alert_decode(&frame, &alert);
+                break;
+            case STREAM_FRAME_LOG:
+                stream_log_t log;
+                if (stream_log_decode(&frame, &log)) {
+                    FUZZ_CHECK(log.count <= STREAM_LOG_MAX_ARGS);
+                    print_log(&log);
+                }
+                break;
+            case STREAM_FRAME_STATS:
+                uint32_t values[8];
+                uint8_t first;
+                uint8_t count;
+                if (stream_stats_decode(&frame, &first, values, 8, &count)) {
+                    FUZZ_CHECK(count <= 8);
+                }
+                break;
+        }
+    }
+    free(p_buf);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t size)
+{
+    decode_frame(p_data, size);
+
+    ingest_parser_t parser;
+    ingest_parser_init(&parser, on_record, NULL);
+    size_t pos = 0;
+    size_t step = size ? p_data[0] % 61 + 1 : 1;
+    while (pos < size) {
+        size_t n = (size - pos < step) ? size - pos : step;
+        ingest_parser_feed(&parser, &p_data[pos], n);
+        pos += n;
+        step = p_data[pos - 1] % 61 + 1;
+    }
+    ingest_parser_flush(&parser);
+    FUZZ_CHECK(parser.bytes == size);
+    return 0;
+}
@@ -0,0 +1,147 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Fuzz target: notifications through ble_sensortag_client.c and its decoders.
+ *
+ * @details  The client is built unchanged against sdk_shim/ and discovers both services with
+ *           the SensorTag's handles. The input is a sequence of events, each one selector byte,
+ *           a 16 bit handle and a length byte, followed by that many bytes of data. Odd
+ *           selectors disconnect and rediscover; even ones deliver a notification, sized
+ *           exactly as the SoftDevice would so that any read past hvx.len is caught.
+ */
+
+#include <string.h>
+
+#include "fuzz.h"
+#include "ble_sensortag_client.h"
+#include "sensortag_payload.h"
+
+#define TEMP_DATA_HANDLE        0x0021
+#define LUXO_DATA_HANDLE        0x0041
+
+static st_client_t m_client;
+static uint16_t    m_next_seq[STREAM_COUNT];                    // Sequence numbers run on across inputs and links
+
+uint32_t sd_ble_uuid_vs_add(const ble_uuid128_t * p_vs_uuid, uint8_t * p_uuid_type)
+{
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN;
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, const ble_gattc_write_params_t * p_write_params)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t ble_db_discovery_evt_register(const ble_uuid_t * p_uuid)
+{
+    return NRF_SUCCESS;
+}
+
+static void check_data(const st_client_evt_t * p_evt, stream_id_t stream, st_client_data_t data)
+{
+    const st_payload_def_t * p_def = st_payload_def(stream);
+    FUZZ_CHECK(data.valid == (p_def->exact_len ? p_evt->data_len == p_def->len : p_evt->data_len >= p_def->len));
+    FUZZ_CHECK(p_evt->seq == m_next_seq[stream]++);
+    if (data.valid) {
+        FUZZ_CHECK(data.raw_count == p_def->value_count && data.raw_count <= ST_CLIENT_MAX_RAW_VALUES);
+        FUZZ_CHECK(data.seq == p_evt->seq);
+    }
+}
+
+static void on_client_evt(st_client_t * p_client, const st_client_evt_t * p_evt)
+{
+    switch (p_evt->evt_type) {
+        case ST_CLIENT_EVT_LUXO_DATA:
+            check_data(p_evt, STREAM_LUXO, extract_luxometer_data(p_evt));
+            FUZZ_CHECK(!extract_temperature_data(p_evt).valid);
+            break;
+        case ST_CLIENT_EVT_TEMP_DATA:
+            check_data(p_evt, STREAM_TEMP, extract_temperature_data(p_evt));
+            FUZZ_CHECK(!extract_luxometer_data(p_evt).valid);
+            break;
+        default:
+            break;
+    }
+}
+
+static void discover(uint16_t service_uuid, uint16_t data_handle)
+{
+    ble_db_discovery_evt_t evt = {
+        .evt_type    = BLE_DB_DISCOVERY_COMPLETE,
+        .conn_handle = 0,
+    };
+    evt.params.discovered_db.srv_uuid = (ble_uuid_t){ .uuid = service_uuid, .type = BLE_UUID_TYPE_VENDOR_BEGIN };
+    evt.params.discovered_db.char_count = 3;
+    static const uint8_t handle_offsets[] = { 0, 3, 5 };                 // DATA, CONF, PERI as on the tag
+    for (uint8_t i = 0; i < 3; ++i) {
+        ble_gatt_db_char_t * p_char = &evt.params.discovered_db.charateristics[i];
+        p_char->characteristic.uuid = (ble_uuid_t){ .uuid = service_uuid + DATA_UUID_OFFSET + i,
+                                                    .type = BLE_UUID_TYPE_VENDOR_BEGIN };
+        p_char->characteristic.handle_value = data_handle + handle_offsets[i];
+        p_char->cccd_handle = (i == 0) ? data_handle + 1 : BLE_CONN_HANDLE_INVALID;
+    }
+    st_client_on_db_disc_evt(&m_client, &evt);
+}
+
+static void connect(void)
+{
+    discover(BLE_UUID_ST_TEMP_SERVICE, TEMP_DATA_HANDLE);
+    discover(BLE_UUID_ST_LUXO_SERVICE, LUXO_DATA_HANDLE);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t size)
+{
+    static bool initialized;
+    if (!initialized) {
+        st_client_init_t init = { .evt_handler = on_client_evt };
+        FUZZ_CHECK(st_client_init(&m_client, &init) == NRF_SUCCESS);
+        connect();
+        initialized = true;
+    }
+
+    size_t pos = 0;
+    while (pos + 4 <= size) {
+        uint8_t selector = p_data[pos];
+        uint16_t handle = p_data[pos + 1] | p_data[pos + 2] << 8;
+        uint16_t len = p_data[pos + 3];
+        pos += 4;
+        if (len > size - pos) {
+            len = size - pos;
+        }
+
+        ble_evt_t * p_evt = malloc(offsetof(ble_evt_t, evt.gattc_evt.params.hvx.data) + len);
+        p_evt->evt.gattc_evt.conn_handle = 0;
+        if (selector & 1) {
+            p_evt->header.evt_id = BLE_GAP_EVT_DISCONNECTED;
+            st_client_on_ble_evt(&m_client, p_evt);
+            FUZZ_CHECK(m_client.conn_handle == BLE_CONN_HANDLE_INVALID);
+            connect();
+        }
+        else {
+            p_evt->header.evt_id = BLE_GATTC_EVT_HVX;
+            p_evt->evt.gattc_evt.params.hvx.handle = handle;
+            p_evt->evt.gattc_evt.params.hvx.type = BLE_GATT_HVX_NOTIFICATION;
+            p_evt->evt.gattc_evt.params.hvx.len = len;
+            memcpy(p_evt->evt.gattc_evt.params.hvx.data, &p_data[pos], len);
+            st_client_on_ble_evt(&m_client, p_evt);
+        }
+        free(p_evt);
+        pos += len;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef FUZZ_SHIM_BLE_H
+#define FUZZ_SHIM_BLE_H
+
+/**@file
+ *
+ * @brief    The few S130/S132 declarations ble_sensortag_client.c needs, for Linux fuzzing.
+ *
+ * @details  Field names and event ids follow the SDK 12.3 headers so that the client builds
+ *           unchanged. This is not a port of the SoftDevice API: only what the fuzz harnesses
+ *           reach is declared, and the sd_* calls are implemented by the harness.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Reached through the SDK's own includes on target
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NRF_SUCCESS                     0
+#define NRF_ERROR_INVALID_STATE         8
+#define NRF_ERROR_NULL                  14
+
+#define BLE_CONN_HANDLE_INVALID         0xFFFF
+#define BLE_UUID_TYPE_UNKNOWN           0x00
+#define BLE_UUID_TYPE_BLE               0x01
+#define BLE_UUID_TYPE_VENDOR_BEGIN      0x02
+
+#define BLE_GATT_HVX_NOTIFICATION       0x01
+#define BLE_CCCD_VALUE_LEN              2
+#define BLE_GATT_OP_WRITE_CMD           0x02
+#define BLE_GATT_EXEC_WRITE_FLAG_PREPARED_WRITE 0x01
+
+#define BLE_GAP_EVT_DISCONNECTED        0x11
+#define BLE_GATTC_EVT_HVX               0x39
+
+typedef struct
+{
+    uint16_t            uuid;
+    uint8_t             type;
+} ble_uuid_t;
+
+typedef struct
+{
+    uint8_t             uuid128[16];
+} ble_uuid128_t;
+
+typedef struct
+{
+    uint16_t            evt_id;
+    uint16_t            evt_len;
+} ble_evt_hdr_t;
+
+typedef struct
+{
+    uint8_t             reason;
+} ble_gap_evt_disconnected_t;
+
+typedef struct
+{
+    uint16_t            conn_handle;
+    union
+    {
+        ble_gap_evt_disconnected_t disconnected;
+    } params;
+} ble_gap_evt_t;
+
+typedef struct
+{
+    uint16_t            handle;
+    uint8_t             type;
+    uint16_t            len;
+    uint8_t             data[1];                // Variable length
+} ble_gattc_evt_hvx_t;
+
+typedef struct
+{
+    uint16_t            conn_handle;
+    uint16_t            gatt_status;
+    uint16_t            error_handle;
+    union
+    {
+        ble_gattc_evt_hvx_t hvx;
+    } params;
+} ble_gattc_evt_t;
+
+typedef struct
+{
+    ble_evt_hdr_t       header;
+    union
+    {
+        ble_gap_evt_t   gap_evt;
+        ble_gattc_evt_t gattc_evt;
+    } evt;
+} ble_evt_t;
+
+typedef struct
+{
+    uint8_t             write_op;
+    uint8_t             flags;
+    uint16_t            handle;
+    uint16_t            offset;
+    uint16_t            len;
+    const uint8_t       *p_value;
+} ble_gattc_write_params_t;
+
+uint32_t sd_ble_uuid_vs_add(const ble_uuid128_t * p_vs_uuid, uint8_t * p_uuid_type);
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, const ble_gattc_write_params_t * p_write_params);
+
+#endif // FUZZ_SHIM_BLE_H
@@ -0,0 +1,65 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/* Discovery event types of the SDK's ble_db_discovery.h, for the Linux fuzz build. */
+
+#ifndef FUZZ_SHIM_BLE_DB_DISCOVERY_H
+#define FUZZ_SHIM_BLE_DB_DISCOVERY_H
+
+#include "ble.h"
+
+#define BLE_GATT_DB_MAX_CHARS           5
+
+typedef enum
+{
+    BLE_DB_DISCOVERY_COMPLETE,
+    BLE_DB_DISCOVERY_ERROR,
+    BLE_DB_DISCOVERY_SRV_NOT_FOUND,
+    BLE_DB_DISCOVERY_AVAILABLE,
+} ble_db_discovery_evt_type_t;
+
+typedef struct
+{
+    ble_uuid_t          uuid;
+    uint16_t            handle_decl;
+    uint16_t            handle_value;
+} ble_gattc_char_t;
+
+typedef struct
+{
+    ble_gattc_char_t    characteristic;
+    uint16_t            cccd_handle;
+} ble_gatt_db_char_t;
+
+typedef struct
+{
+    ble_uuid_t          srv_uuid;
+    uint8_t             char_count;
+    ble_gatt_db_char_t  charateristics[BLE_GATT_DB_MAX_CHARS];
+} ble_gatt_db_srv_t;
+
+typedef struct
+{
+    ble_db_discovery_evt_type_t evt_type;
+    uint16_t            conn_handle;
+    union
+    {
+        ble_gatt_db_srv_t discovered_db;
+    } params;
+} ble_db_discovery_evt_t;
+
+uint32_t ble_db_discovery_evt_register(const ble_uuid_t * p_uuid);
+
+#endif // FUZZ_SHIM_BLE_DB_DISCOVERY_H
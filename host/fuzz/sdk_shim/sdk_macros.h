@@ -0,0 +1,40 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/* VERIFY_ macros of the SDK's sdk_macros.h, for the Linux fuzz build. */
+
+#ifndef FUZZ_SHIM_SDK_MACROS_H
+#define FUZZ_SHIM_SDK_MACROS_H
+
+#define VERIFY_SUCCESS(statement)                   \
+do                                                  \
+{                                                   \
+    uint32_t _err_code = (uint32_t)(statement);     \
+    if (_err_code != NRF_SUCCESS)                   \
+    {                                               \
+        return _err_code;                           \
+    }                                               \
+} while (0)
+
+#define VERIFY_PARAM_NOT_NULL(param)                \
+do                                                  \
+{                                                   \
+    if ((param) == NULL)                            \
+    {                                               \
+        return NRF_ERROR_NULL;                      \
+    }                                               \
+} while (0)
+
+#endif // FUZZ_SHIM_SDK_MACROS_H
@@ -0,0 +1,148 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ingest_log.h"
+
+void ingest_record_header_pack(uint64_t host_ns, uint8_t kind, uint16_t len, uint8_t * p_out)
+{
+    for (int i = 0; i < 8; ++i) {
+        p_out[i] = (uint8_t)(host_ns >> (8 * i));
+    }
+    p_out[8]  = kind;
+    p_out[9]  = 0;
+    p_out[10] = (uint8_t)len;
+    p_out[11] = (uint8_t)(len >> 8);
+}
+
+bool ingest_record_header_unpack(const uint8_t * p_in, ingest_record_t * p_record)
+{
+    p_record->host_ns = 0;
+    for (int i = 0; i < 8; ++i) {
+        p_record->host_ns |= (uint64_t)p_in[i] << (8 * i);
+    }
+    p_record->kind = p_in[8];
+    p_record->len  = (uint16_t)(p_in[10] | (p_in[11] << 8));
+    return (p_record->kind == INGEST_RECORD_FRAME || p_record->kind == INGEST_RECORD_TEXT)
+        && p_in[9] == 0
+        && p_record->len <= INGEST_RECORD_MAX_DATA;
+}
+
+int ingest_log_write(int fd, const uint8_t * p_data, size_t len)
+{
+    while (len > 0) {
+        ssize_t written = write(fd, p_data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("log write");
+            return -1;
+        }
+        p_data += written;
+        len -= written;
+    }
+    return 0;
+}
+
+int ingest_log_open(const char * p_path)
+{
+    int fd = open(p_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror(p_path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(p_path);
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        uint8_t header[INGEST_LOG_HEADER_LEN];
+        memcpy(header, INGEST_LOG_MAGIC, sizeof(INGEST_LOG_MAGIC) - 1);
+        header[INGEST_LOG_HEADER_LEN - 1] = INGEST_LOG_VERSION;
+        if (ingest_log_write(fd, header, sizeof(header)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+int ingest_log_reader_open(ingest_log_reader_t * p_reader, const char * p_path)
+{
+    memset(p_reader, 0, sizeof(*p_reader));
+    int fd = open(p_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(p_path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < INGEST_LOG_HEADER_LEN) {
+        fprintf(stderr, "%s: not an ingest log\n", p_path);
+        close(fd);
+        return -1;
+    }
+    void * p_map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        perror(p_path);
+        return -1;
+    }
+    madvise(p_map, st.st_size, MADV_SEQUENTIAL);
+
+    p_reader->p_map = p_map;
+    p_reader->size = st.st_size;
+    if (memcmp(p_reader->p_map, INGEST_LOG_MAGIC, sizeof(INGEST_LOG_MAGIC) - 1) != 0 ||
+        p_reader->p_map[INGEST_LOG_HEADER_LEN - 1] != INGEST_LOG_VERSION)
+    {
+        fprintf(stderr, "%s: not an ingest log\n", p_path);
+        ingest_log_reader_close(p_reader);
+        return -1;
+    }
+    p_reader->pos = INGEST_LOG_HEADER_LEN;
+    return 0;
+}
+
+bool ingest_log_reader_next(ingest_log_reader_t * p_reader, ingest_record_t * p_record)
+{
+    if (p_reader->size - p_reader->pos < INGEST_RECORD_HEADER_LEN ||
+        !ingest_record_header_unpack(&p_reader->p_map[p_reader->pos], p_record) ||
+        p_reader->size - p_reader->pos - INGEST_RECORD_HEADER_LEN < p_record->len)
+    {
+        return false;
+    }
+    p_record->p_data = &p_reader->p_map[p_reader->pos + INGEST_RECORD_HEADER_LEN];
+    p_reader->pos += INGEST_RECORD_HEADER_LEN + p_record->len;
+    return true;
+}
+
+void ingest_log_reader_close(ingest_log_reader_t * p_reader)
+{
+    if (p_reader->p_map != NULL) {
+        munmap((void *)p_reader->p_map, p_reader->size);
+        p_reader->p_map = NULL;
+    }
+}
@@ -0,0 +1,94 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef INGEST_LOG_H
+#define INGEST_LOG_H
+
+/**@file
+ *
+ * @brief    Record format shared by the ingest ring and the on-disk ingest log.
+ *
+ * @details  st_ingestd turns the gateway byte stream into records and appends them to a log:
+ *
+ *               file:    "STLOG\0\0" | version
+ *               record:  host_ns (u64) | kind (u8) | 0 (u8) | len (u16) | len data bytes
+ *
+ *           All integers are little endian. host_ns is CLOCK_REALTIME when the bytes were read.
+ *           A frame record holds the frame body after COBS decoding and CRC check, without the
+ *           CRC (type | frame_seq | payload); a text record holds one line without its newline.
+ *           The in-memory ring stores records in the same layout, so the log writer copies ring
+ *           contents to disk as they are.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define INGEST_LOG_MAGIC            "STLOG\0\0"
+#define INGEST_LOG_VERSION          1
+#define INGEST_LOG_HEADER_LEN       8
+#define INGEST_RECORD_HEADER_LEN    12
+#define INGEST_RECORD_MAX_DATA      512                         /**< Longer text lines are split. */
+
+typedef enum
+{
+    INGEST_RECORD_FRAME = 1,                // Decoded frame body: type | frame_seq | payload
+    INGEST_RECORD_TEXT  = 2,                // One line of text output or diagnostics
+} ingest_record_kind_t;
+
+typedef struct
+{
+    uint64_t            host_ns;
+    uint8_t             kind;
+    uint16_t            len;
+    const uint8_t       *p_data;
+} ingest_record_t;
+
+/**@brief   Write a record header to p_out (INGEST_RECORD_HEADER_LEN bytes). */
+void ingest_record_header_pack(uint64_t host_ns, uint8_t kind, uint16_t len, uint8_t * p_out);
+
+/**@brief   Read a record header. Returns false if it is not a valid header. */
+bool ingest_record_header_unpack(const uint8_t * p_in, ingest_record_t * p_record);
+
+/**@brief   Open a log for appending, writing the file header if it is new.
+ *
+ * @return  File descriptor, or -1 with a message on stderr.
+ */
+int ingest_log_open(const char * p_path);
+
+/**@brief   Write all of p_data to fd. Returns 0 on success, -1 with a message on stderr. */
+int ingest_log_write(int fd, const uint8_t * p_data, size_t len);
+
+/**@brief Sequential reader over a memory mapped log. */
+typedef struct
+{
+    const uint8_t       *p_map;
+    size_t              size;
+    size_t              pos;
+} ingest_log_reader_t;
+
+/**@brief   Map a log for reading. Returns 0 on success, -1 with a message on stderr. */
+int ingest_log_reader_open(ingest_log_reader_t * p_reader, const char * p_path);
+
+/**@brief   Next record; p_record->p_data points into the mapping.
+ *
+ * @retval  false at the end of the log, or at a damaged or incomplete record.
+ */
+bool ingest_log_reader_next(ingest_log_reader_t * p_reader, ingest_record_t * p_record);
+
+/**@brief   Unmap a log. */
+void ingest_log_reader_close(ingest_log_reader_t * p_reader);
+
+#endif // INGEST_LOG_H
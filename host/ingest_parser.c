@@ -0,0 +1,168 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <string.h>
+
+#include "ingest_parser.h"
+
+#define FRAME_SEGMENT_MAX       (STREAM_FRAME_MAX_ENCODED - 2)  /**< Longest segment that can be a frame. */
+
+void ingest_parser_init(ingest_parser_t * p_parser, ingest_record_handler_t handler, void * p_context)
+{
+    memset(p_parser, 0, sizeof(*p_parser));
+    p_parser->handler = handler;
+    p_parser->p_context = p_context;
+}
+
+static void emit_line(ingest_parser_t * p_parser, const uint8_t * p_line, size_t len)
+{
+    if (len > 0 && p_line[len - 1] == '\r') {
+        --len;
+    }
+    if (len == 0) {
+        return;
+    }
+    ++p_parser->lines;
+    p_parser->handler(p_parser->p_context, INGEST_RECORD_TEXT, p_line, (uint16_t)len);
+}
+
+static void carry_append(ingest_parser_t * p_parser, const uint8_t * p_data, size_t len)
+{
+    while (len > 0) {
+        size_t room = sizeof(p_parser->carry) - p_parser->carry_len;
+        if (room == 0) {
+            // Line longer than a record: split it
+            emit_line(p_parser, p_parser->carry, p_parser->carry_len);
+            p_parser->carry_len = 0;
+            continue;
+        }
+        size_t n = (len < room) ? len : room;
+        memmove(&p_parser->carry[p_parser->carry_len], p_data, n);
+        p_parser->carry_len += n;
+        p_data += n;
+        len -= n;
+    }
+}
+
+/**@brief Cut text into lines, completing any line held in carry first. */
+static void text_put(ingest_parser_t * p_parser, const uint8_t * p_data, size_t len, bool closed)
+{
+    const uint8_t * p_nl;
+    while (len > 0 && (p_nl = memchr(p_data, '\n', len)) != NULL) {
+        size_t n = p_nl - p_data;
+        if (p_parser->carry_len == 0 && n <= INGEST_RECORD_MAX_DATA) {
+            emit_line(p_parser, p_data, n);
+        }
+        else {
+            carry_append(p_parser, p_data, n);
+            emit_line(p_parser, p_parser->carry, p_parser->carry_len);
+            p_parser->carry_len = 0;
+        }
+        p_data += n + 1;
+        len -= n + 1;
+    }
+    carry_append(p_parser, p_data, len);
+    if (closed) {
+        emit_line(p_parser, p_parser->carry, p_parser->carry_len);
+        p_parser->carry_len = 0;
+    }
+}
+
+static bool frame_put(ingest_parser_t * p_parser, const uint8_t * p_segment, size_t len)
+{
+    uint8_t body[FRAME_SEGMENT_MAX];
+    stream_frame_t frame;
+
+    memcpy(body, p_segment, len);
+    if (!stream_frame_decode(body, (uint16_t)len, &frame)) {
+        return false;
+    }
+
+    stream_seq_space_t space = stream_frame_seq_space(frame.type);
+    if (p_parser->seq_valid[space]) {
+        p_parser->seq_gaps += (uint8_t)(frame.frame_seq - p_parser->last_seq[space] - 1);
+    }
+    p_parser->seq_valid[space] = true;
+    p_parser->last_seq[space] = frame.frame_seq;
+    ++p_parser->frames;
+    p_parser->handler(p_parser->p_context, INGEST_RECORD_FRAME, body,
+                      STREAM_FRAME_HEADER_LEN + frame.len);
+    return true;
+}
+
+/**@brief Take the next piece of the current segment; closed when it ends at a delimiter. */
+static void segment_put(ingest_parser_t * p_parser, const uint8_t * p_data, size_t len, bool closed)
+{
+    if (!p_parser->in_text && p_parser->carry_len + len <= FRAME_SEGMENT_MAX) {
+        if (!closed) {
+            carry_append(p_parser, p_data, len);
+            return;
+        }
+        const uint8_t * p_segment = p_data;
+        if (p_parser->carry_len > 0) {
+            carry_append(p_parser, p_data, len);
+            p_segment = p_parser->carry;
+            len = p_parser->carry_len;
+        }
+        if (len == 0 || frame_put(p_parser, p_segment, len)) {
+            p_parser->carry_len = 0;
+            return;
+        }
+        // Not a frame: the segment is text, possibly cut into lines from carry itself
+        p_parser->carry_len = 0;
+        text_put(p_parser, p_segment, len, true);
+        return;
+    }
+
+    if (!p_parser->in_text) {
+        // Too long for a frame: what was held back is the start of some text
+        uint8_t held[FRAME_SEGMENT_MAX];
+        size_t held_len = p_parser->carry_len;
+        memcpy(held, p_parser->carry, held_len);
+        p_parser->carry_len = 0;
+        p_parser->in_text = true;
+        text_put(p_parser, held, held_len, false);
+    }
+    text_put(p_parser, p_data, len, closed);
+    if (closed) {
+        p_parser->in_text = false;
+    }
+}
+
+void ingest_parser_feed(ingest_parser_t * p_parser, const uint8_t * p_data, size_t len)
+{
+    p_parser->bytes += len;
+    while (len > 0) {
+        const uint8_t * p_delim = memchr(p_data, STREAM_FRAME_DELIMITER, len);
+        size_t n = p_delim ? (size_t)(p_delim - p_data) : len;
+        segment_put(p_parser, p_data, n, p_delim != NULL);
+        if (p_delim == NULL) {
+            break;
+        }
+        p_data += n + 1;
+        len -= n + 1;
+    }
+}
+
+void ingest_parser_flush(ingest_parser_t * p_parser)
+{
+    // A segment held back as a possible frame was never closed, so it is text and may hold several lines
+    uint8_t held[INGEST_RECORD_MAX_DATA];
+    size_t held_len = p_parser->carry_len;
+    memcpy(held, p_parser->carry, held_len);
+    p_parser->carry_len = 0;
+    text_put(p_parser, held, held_len, true);
+    p_parser->in_text = false;
+}
@@ -0,0 +1,71 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef INGEST_PARSER_H
+#define INGEST_PARSER_H
+
+/**@file
+ *
+ * @brief    Splits the gateway byte stream into frames and text lines.
+ *
+ * @details  The gateway interleaves compressed frames with plain text (text mode samples,
+ *           command replies, diagnostics). Every 0x00 is treated as a delimiter; each segment
+ *           between two delimiters that decodes with a good CRC is a frame, anything else is
+ *           text and is cut into lines. A segment longer than any frame is known to be text as
+ *           soon as it passes STREAM_FRAME_MAX_ENCODED, so text mode output is emitted line by
+ *           line without waiting for a delimiter that never comes.
+ *
+ *           Input is scanned where it was read. Only segments that straddle two reads are
+ *           copied, and a candidate frame is COBS decoded into a small scratch buffer so that
+ *           a text segment that fails as a frame is still intact.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "stream_codec.h"
+#include "ingest_log.h"
+
+/**@brief   Callback for each record found; p_data is only valid during the call. */
+typedef void (* ingest_record_handler_t)(void * p_context, uint8_t kind,
+                                         const uint8_t * p_data, uint16_t len);
+
+typedef struct
+{
+    uint8_t             carry[INGEST_RECORD_MAX_DATA];  // Start of a segment or line split across reads
+    size_t              carry_len;
+    bool                in_text;                // Current segment is too long to be a frame
+    bool                seq_valid[STREAM_SEQ_COUNT];
+    uint8_t             last_seq[STREAM_SEQ_COUNT];
+    ingest_record_handler_t handler;
+    void                *p_context;
+
+    uint64_t            bytes;
+    uint64_t            frames;
+    uint64_t            lines;
+    uint64_t            seq_gaps;               // Frames missing according to frame_seq
+} ingest_parser_t;
+
+/**@brief   Reset the parser and its counters. */
+void ingest_parser_init(ingest_parser_t * p_parser, ingest_record_handler_t handler, void * p_context);
+
+/**@brief   Parse the next chunk of input. */
+void ingest_parser_feed(ingest_parser_t * p_parser, const uint8_t * p_data, size_t len);
+
+/**@brief   End of input: emit any partial line. */
+void ingest_parser_flush(ingest_parser_t * p_parser);
+
+#endif // INGEST_PARSER_H
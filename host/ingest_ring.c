@@ -0,0 +1,120 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ingest_ring.h"
+#include "ingest_log.h"
+
+int ingest_ring_init(ingest_ring_t * p_ring, size_t size)
+{
+    memset(p_ring, 0, sizeof(*p_ring));
+    p_ring->size = 1;
+    while (p_ring->size < size || p_ring->size < INGEST_RECORD_HEADER_LEN + INGEST_RECORD_MAX_DATA) {
+        p_ring->size <<= 1;
+    }
+    p_ring->p_buf = malloc(p_ring->size);
+    if (p_ring->p_buf == NULL) {
+        return -1;
+    }
+    pthread_mutex_init(&p_ring->lock, NULL);
+    pthread_cond_init(&p_ring->not_empty, NULL);
+    pthread_cond_init(&p_ring->not_full, NULL);
+    return 0;
+}
+
+void ingest_ring_free(ingest_ring_t * p_ring)
+{
+    pthread_cond_destroy(&p_ring->not_full);
+    pthread_cond_destroy(&p_ring->not_empty);
+    pthread_mutex_destroy(&p_ring->lock);
+    free(p_ring->p_buf);
+    p_ring->p_buf = NULL;
+}
+
+static void ring_copy_in(ingest_ring_t * p_ring, size_t pos, const uint8_t * p_data, size_t len)
+{
+    size_t offset = pos & (p_ring->size - 1);
+    size_t first = p_ring->size - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&p_ring->p_buf[offset], p_data, first);
+    memcpy(p_ring->p_buf, p_data + first, len - first);
+}
+
+bool ingest_ring_publish(ingest_ring_t * p_ring, uint64_t host_ns, uint8_t kind,
+                         const uint8_t * p_data, uint16_t len, bool block)
+{
+    size_t total = INGEST_RECORD_HEADER_LEN + len;
+
+    pthread_mutex_lock(&p_ring->lock);
+    while (p_ring->size - (p_ring->head - p_ring->tail) < total) {
+        if (!block) {
+            ++p_ring->dropped;
+            pthread_mutex_unlock(&p_ring->lock);
+            return false;
+        }
+        pthread_cond_wait(&p_ring->not_full, &p_ring->lock);
+    }
+    size_t head = p_ring->head;
+    pthread_mutex_unlock(&p_ring->lock);
+
+    uint8_t header[INGEST_RECORD_HEADER_LEN];
+    ingest_record_header_pack(host_ns, kind, len, header);
+    ring_copy_in(p_ring, head, header, sizeof(header));
+    ring_copy_in(p_ring, head + sizeof(header), p_data, len);
+
+    pthread_mutex_lock(&p_ring->lock);
+    bool was_empty = (p_ring->head == p_ring->tail);
+    p_ring->head = head + total;
+    ++p_ring->records;
+    if (was_empty) {
+        pthread_cond_signal(&p_ring->not_empty);
+    }
+    pthread_mutex_unlock(&p_ring->lock);
+    return true;
+}
+
+size_t ingest_ring_peek(ingest_ring_t * p_ring, const uint8_t ** pp_data)
+{
+    pthread_mutex_lock(&p_ring->lock);
+    while (p_ring->head == p_ring->tail && !p_ring->closed) {
+        pthread_cond_wait(&p_ring->not_empty, &p_ring->lock);
+    }
+    size_t used = p_ring->head - p_ring->tail;
+    size_t offset = p_ring->tail & (p_ring->size - 1);
+    pthread_mutex_unlock(&p_ring->lock);
+
+    *pp_data = &p_ring->p_buf[offset];
+    return (used < p_ring->size - offset) ? used : p_ring->size - offset;
+}
+
+void ingest_ring_consume(ingest_ring_t * p_ring, size_t len)
+{
+    pthread_mutex_lock(&p_ring->lock);
+    p_ring->tail += len;
+    pthread_cond_signal(&p_ring->not_full);
+    pthread_mutex_unlock(&p_ring->lock);
+}
+
+void ingest_ring_close(ingest_ring_t * p_ring)
+{
+    pthread_mutex_lock(&p_ring->lock);
+    p_ring->closed = true;
+    pthread_cond_broadcast(&p_ring->not_empty);
+    pthread_mutex_unlock(&p_ring->lock);
+}
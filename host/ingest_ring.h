@@ -0,0 +1,77 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef INGEST_RING_H
+#define INGEST_RING_H
+
+/**@file
+ *
+ * @brief    In-memory ring of ingest records between the reader and its consumers.
+ *
+ * @details  One publisher (the input reader) and one consumer (the log writer). Records are
+ *           stored back to back in the ingest_log.h layout, so the consumer takes whole spans
+ *           of the ring and hands them to write() without touching individual records. The
+ *           lock only guards the two positions; record bytes are copied in and written out
+ *           outside it, since the publisher and consumer never work on the same bytes.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct
+{
+    uint8_t             *p_buf;
+    size_t              size;                   // Power of two
+    size_t              head;                   // Free running; publisher owns [head, tail + size)
+    size_t              tail;                   // Free running; consumer owns [tail, head)
+    bool                closed;
+    uint64_t            records;
+    uint64_t            dropped;
+    pthread_mutex_t     lock;
+    pthread_cond_t      not_empty;
+    pthread_cond_t      not_full;
+} ingest_ring_t;
+
+/**@brief   Allocate a ring of size bytes, rounded up to a power of two. Returns 0 on success. */
+int ingest_ring_init(ingest_ring_t * p_ring, size_t size);
+
+/**@brief   Release the ring's memory. */
+void ingest_ring_free(ingest_ring_t * p_ring);
+
+/**@brief   Append one record.
+ *
+ * @param[in] block   Wait for the consumer when the ring is full (replay), rather than dropping
+ *                    the record and counting it (live input, which cannot be paused).
+ *
+ * @retval    true if the record was stored.
+ */
+bool ingest_ring_publish(ingest_ring_t * p_ring, uint64_t host_ns, uint8_t kind,
+                         const uint8_t * p_data, uint16_t len, bool block);
+
+/**@brief   Wait for data and return the contiguous span at the tail of the ring.
+ *
+ * @return  Bytes available at *pp_data; 0 once the ring is closed and drained.
+ */
+size_t ingest_ring_peek(ingest_ring_t * p_ring, const uint8_t ** pp_data);
+
+/**@brief   Release len bytes returned by ingest_ring_peek. */
+void ingest_ring_consume(ingest_ring_t * p_ring, size_t len);
+
+/**@brief   No more records will be published; wakes the consumer. */
+void ingest_ring_close(ingest_ring_t * p_ring);
+
+#endif // INGEST_RING_H
@@ -0,0 +1,124 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <string.h>
+
+#include "lod_pyramid.h"
+
+void lod_init(lod_pyramid_t * p_pyramid)
+{
+    memset(p_pyramid, 0, sizeof(*p_pyramid));
+    int64_t width = LOD_BASE_NS;
+    for (int level = 0; level < LOD_LEVELS; ++level) {
+        p_pyramid->levels[level].width = width;
+        width *= LOD_FANOUT;
+    }
+}
+
+static int64_t bucket_start(int64_t t, int64_t width)
+{
+    int64_t start = t - t % width;
+    return (t < 0 && start != t) ? start - width : start;
+}
+
+/**@brief Merge a summary into a level, closing its open bucket when the summary is past it. */
+static void level_put(lod_pyramid_t * p_pyramid, int level, const lod_bucket_t * p_in)
+{
+    lod_level_t * p_level = &p_pyramid->levels[level];
+    lod_bucket_t * p_open = &p_level->open;
+    int64_t start = bucket_start(p_in->t_start, p_level->width);
+
+    if (p_open->count > 0 && start != p_open->t_start) {
+        p_level->ring[p_level->closed % LOD_LEVEL_BUCKETS] = *p_open;
+        ++p_level->closed;
+        if (level + 1 < LOD_LEVELS) {
+            level_put(p_pyramid, level + 1, p_open);
+        }
+        p_open->count = 0;
+    }
+    if (p_open->count == 0) {
+        *p_open = (lod_bucket_t) { .t_start = start, .min = p_in->min, .max = p_in->max };
+    }
+    p_open->min = (p_in->min < p_open->min) ? p_in->min : p_open->min;
+    p_open->max = (p_in->max > p_open->max) ? p_in->max : p_open->max;
+    p_open->count += p_in->count;
+    p_open->sum += p_in->sum;
+}
+
+void lod_put(lod_pyramid_t * p_pyramid, int64_t t, int32_t v)
+{
+    lod_bucket_t sample = { .t_start = t, .count = 1, .min = v, .max = v, .sum = v };
+    level_put(p_pyramid, 0, &sample);
+    ++p_pyramid->samples;
+}
+
+/**@brief Oldest time a level still covers. */
+static int64_t level_oldest(const lod_level_t * p_level)
+{
+    if (p_level->closed == 0) {
+        return p_level->open.count ? p_level->open.t_start : INT64_MAX;
+    }
+    uint64_t oldest = (p_level->closed > LOD_LEVEL_BUCKETS) ? p_level->closed - LOD_LEVEL_BUCKETS : 0;
+    return p_level->ring[oldest % LOD_LEVEL_BUCKETS].t_start;
+}
+
+size_t lod_query(const lod_pyramid_t * p_pyramid, int64_t t0, int64_t t1,
+                 lod_bucket_t * p_out, size_t max_count, uint8_t * p_level)
+{
+    if (max_count == 0 || t1 <= t0) {
+        return 0;
+    }
+
+    // Finest level that is coarse enough and reaches back to t0; else the coarsest
+    int level = 0;
+    while (level + 1 < LOD_LEVELS &&
+           ((t1 - t0) / p_pyramid->levels[level].width > (int64_t)max_count ||
+            level_oldest(&p_pyramid->levels[level]) > t0))
+    {
+        ++level;
+    }
+    *p_level = (uint8_t)level;
+
+    const lod_level_t * p_lvl = &p_pyramid->levels[level];
+    uint64_t oldest = (p_lvl->closed > LOD_LEVEL_BUCKETS) ? p_lvl->closed - LOD_LEVEL_BUCKETS : 0;
+
+    // Binary search for the first closed bucket that ends after t0
+    uint64_t lo = oldest;
+    uint64_t hi = p_lvl->closed;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (p_lvl->ring[mid % LOD_LEVEL_BUCKETS].t_start + p_lvl->width <= t0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    size_t count = 0;
+    for (uint64_t i = lo; i < p_lvl->closed && count < max_count; ++i) {
+        const lod_bucket_t * p_bucket = &p_lvl->ring[i % LOD_LEVEL_BUCKETS];
+        if (p_bucket->t_start >= t1) {
+            return count;
+        }
+        p_out[count++] = *p_bucket;
+    }
+    if (p_lvl->open.count > 0 && p_lvl->open.t_start < t1 && count < max_count &&
+        p_lvl->open.t_start + p_lvl->width > t0)
+    {
+        p_out[count++] = p_lvl->open;
+    }
+    return count;
+}
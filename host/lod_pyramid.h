@@ -0,0 +1,83 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef LOD_PYRAMID_H
+#define LOD_PYRAMID_H
+
+/**@file
+ *
+ * @brief    Multi-resolution min/max pyramid of one channel, for plotting.
+ *
+ * @details  Level 0 summarises the samples in buckets of LOD_BASE_NS; each level above uses
+ *           buckets LOD_FANOUT times wider. Every level keeps its last LOD_LEVEL_BUCKETS
+ *           buckets in a ring, so the finer levels cover recent minutes and the coarser ones
+ *           weeks, in fixed memory. A sample updates the open level 0 bucket; a bucket that
+ *           closes is merged into the open bucket of the level above, so the cost per sample
+ *           is constant.
+ *
+ *           A view of [t0, t1) in at most N buckets comes from the finest level with at least
+ *           (t1 - t0) / N per bucket that still holds t0. Plotting min and max of each bucket
+ *           draws the same envelope as every sample would, from 2N points. A level's open
+ *           bucket is included, but not the open buckets of the levels below, so the newest
+ *           point of a coarse view lags by up to one finer bucket.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LOD_LEVELS                  8
+#define LOD_FANOUT                  4
+#define LOD_LEVEL_BUCKETS           4096
+#define LOD_BASE_NS                 100000000LL                 /**< 100 ms: one sample at 10 Hz */
+
+typedef struct
+{
+    int64_t             t_start;
+    uint32_t            count;
+    int32_t             min;
+    int32_t             max;
+    int64_t             sum;
+} lod_bucket_t;
+
+typedef struct
+{
+    int64_t             width;
+    lod_bucket_t        open;
+    uint64_t            closed;                 // Buckets ever closed; ring[closed % LOD_LEVEL_BUCKETS] is next
+    lod_bucket_t        ring[LOD_LEVEL_BUCKETS];
+} lod_level_t;
+
+typedef struct
+{
+    lod_level_t         levels[LOD_LEVELS];
+    uint64_t            samples;
+} lod_pyramid_t;
+
+/**@brief   Reset a pyramid. */
+void lod_init(lod_pyramid_t * p_pyramid);
+
+/**@brief   Add a sample. Samples must arrive in time order. */
+void lod_put(lod_pyramid_t * p_pyramid, int64_t t, int32_t v);
+
+/**@brief   Buckets covering [t0, t1), at most max_count of them, oldest first.
+ *
+ * @param[out] p_level  Level the buckets came from
+ *
+ * @return  Number of buckets written to p_out.
+ */
+size_t lod_query(const lod_pyramid_t * p_pyramid, int64_t t0, int64_t t1,
+                 lod_bucket_t * p_out, size_t max_count, uint8_t * p_level);
+
+#endif // LOD_PYRAMID_H
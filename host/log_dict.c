@@ -0,0 +1,179 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_dict.h"
+
+#define SPEC_MAX                16                              /**< Longest conversion kept: '%', flags, width, precision, type. */
+
+typedef struct
+{
+    char                *p_buf;
+    size_t              size;
+    size_t              len;
+} out_t;
+
+static void out_printf(out_t * p_out, const char * p_format, ...)
+{
+    size_t room = p_out->size - p_out->len;
+    va_list args;
+    va_start(args, p_format);
+    int n = vsnprintf(&p_out->p_buf[p_out->len], room, p_format, args);
+    va_end(args);
+    if (n > 0) {
+        p_out->len += ((size_t)n < room) ? (size_t)n : room - 1;
+    }
+}
+
+int log_dict_load(log_dict_t * p_dict, const char * p_path)
+{
+    FILE * p_file = fopen(p_path, "rb");
+    if (p_file == NULL) {
+        perror(p_path);
+        return -1;
+    }
+    p_dict->p_strings = NULL;
+    p_dict->size = 0;
+    size_t capacity = 0;
+    int result = 0;
+    while (result == 0) {
+        if (p_dict->size == capacity) {
+            capacity = capacity ? 2 * capacity : 4096;
+            char * p_strings = realloc(p_dict->p_strings, capacity);
+            if (p_strings == NULL) {
+                fprintf(stderr, "%s: out of memory\n", p_path);
+                result = -1;
+                break;
+            }
+            p_dict->p_strings = p_strings;
+        }
+        size_t n = fread(&p_dict->p_strings[p_dict->size], 1, capacity - p_dict->size, p_file);
+        p_dict->size += n;
+        if (n == 0) {
+            if (ferror(p_file)) {
+                perror(p_path);
+                result = -1;
+            }
+            break;
+        }
+    }
+    fclose(p_file);
+    if (result != 0) {
+        log_dict_free(p_dict);
+    }
+    return result;
+}
+
+void log_dict_free(log_dict_t * p_dict)
+{
+    free(p_dict->p_strings);
+    p_dict->p_strings = NULL;
+    p_dict->size = 0;
+}
+
+const char * log_dict_lookup(const log_dict_t * p_dict, uint32_t token)
+{
+    if (token >= p_dict->size || p_dict->p_strings[token] == '\0' ||
+        (token > 0 && p_dict->p_strings[token - 1] != '\0'))
+    {
+        return NULL;
+    }
+    // The last string of a damaged file may lack its NUL
+    if (memchr(&p_dict->p_strings[token], '\0', p_dict->size - token) == NULL) {
+        return NULL;
+    }
+    return &p_dict->p_strings[token];
+}
+
+size_t log_dict_format(const log_dict_t * p_dict, const stream_log_t * p_log, char * p_out, size_t size)
+{
+    out_t out = { .p_buf = p_out, .size = size };
+    p_out[0] = '\0';
+
+    const char * p_format = log_dict_lookup(p_dict, p_log->token);
+    if (p_format == NULL) {
+        out_printf(&out, "[LOG] unknown token 0x%x", (unsigned)p_log->token);
+        for (uint8_t i = 0; i < p_log->count; ++i) {
+            out_printf(&out, " %d", (int)p_log->args[i]);
+        }
+        return out.len;
+    }
+
+    uint8_t arg = 0;
+    while (*p_format != '\0') {
+        const char * p_percent = strchr(p_format, '%');
+        if (p_percent == NULL) {
+            out_printf(&out, "%s", p_format);
+            break;
+        }
+        out_printf(&out, "%.*s", (int)(p_percent - p_format), p_format);
+        p_format = p_percent + 1;
+        if (*p_format == '%') {
+            out_printf(&out, "%%");
+            ++p_format;
+            continue;
+        }
+
+        // Keep flags, width and precision; drop length modifiers, every argument is 32 bits
+        char spec[SPEC_MAX] = "%";
+        size_t spec_len = 1;
+        size_t kept = strspn(p_format, "-+ #0");
+        kept += strspn(&p_format[kept], "0123456789");
+        if (p_format[kept] == '.') {
+            kept += 1 + strspn(&p_format[kept + 1], "0123456789");
+        }
+        bool fits = kept < SPEC_MAX - 2;
+        if (fits) {
+            memcpy(&spec[1], p_format, kept);
+            spec_len += kept;
+        }
+        p_format += kept;
+        p_format += strspn(p_format, "hlLqjzt");
+        char conversion = *p_format;
+        if (conversion == '\0') {
+            break;
+        }
+        ++p_format;
+        spec[spec_len++] = conversion;
+        spec[spec_len] = '\0';
+
+        if (!fits || arg == p_log->count) {
+            out_printf(&out, "?");
+            continue;
+        }
+        int32_t value = p_log->args[arg++];
+        switch (conversion) {
+            case 'd':
+            case 'i':
+            case 'c':
+                out_printf(&out, spec, (int)value);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                out_printf(&out, spec, (unsigned)value);
+                break;
+            default:
+                out_printf(&out, "?");
+                break;
+        }
+    }
+    return out.len;
+}
@@ -0,0 +1,68 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef LOG_DICT_H
+#define LOG_DICT_H
+
+/**@file
+ *
+ * @brief    Prints the gateway's tokenized diagnostics from its log dictionary.
+ *
+ * @details  The dictionary is the .log_strings section of the firmware ELF, extracted with
+ *           `make log_strings`: the format strings back to back, each ending in a NUL, some
+ *           followed by alignment padding. A token is the offset of its string, so only an
+ *           offset at the start of a string is accepted; a dictionary from another build
+ *           prints other messages, or none.
+ *
+ *           The format strings are printed with the arguments as 32 bit words, whatever their
+ *           length modifiers say. Conversions the firmware cannot send (strings, pointers,
+ *           floats) and missing arguments print as '?'.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "stream_codec.h"
+
+typedef struct
+{
+    char                *p_strings;
+    size_t              size;
+} log_dict_t;
+
+/**@brief   Read a dictionary file. Returns 0, or -1 with the reason printed. */
+int log_dict_load(log_dict_t * p_dict, const char * p_path);
+
+/**@brief   Free a dictionary read by log_dict_load. */
+void log_dict_free(log_dict_t * p_dict);
+
+/**@brief   The format string of a token, or NULL if the token does not start one. */
+const char * log_dict_lookup(const log_dict_t * p_dict, uint32_t token);
+
+/**@brief   Print a diagnostic as the firmware would have with printf.
+ *
+ * @details An unknown token prints as the token and arguments, marked as unknown.
+ *
+ * @param[in]  p_dict   Dictionary
+ * @param[in]  p_log    Token and arguments
+ * @param[out] p_out    Output, always NUL terminated and cut short as needed
+ * @param[in]  size     Size of p_out, at least 1
+ *
+ * @return  Length of the text in p_out.
+ */
+size_t log_dict_format(const log_dict_t * p_dict, const stream_log_t * p_log, char * p_out, size_t size);
+
+#endif // LOG_DICT_H
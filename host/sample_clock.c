@@ -0,0 +1,117 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <string.h>
+
+#include "sample_clock.h"
+
+typedef struct
+{
+    const sample_clock_t *p_clock;
+    sample_handler_t    handler;
+    void                *p_context;
+} place_ctx_t;
+
+/**@brief RTC1 ticks (32768 Hz) to nanoseconds: 1e9 / 32768 = 1953125 / 64. */
+static int64_t ticks_to_ns(uint64_t ticks)
+{
+    return (int64_t)((ticks * 1953125ULL) >> 6);
+}
+
+void sample_clock_init(sample_clock_t * p_clock, bool live)
+{
+    memset(p_clock, 0, sizeof(*p_clock));
+    p_clock->live = live;
+    time_sync_init(&p_clock->sync);
+}
+
+static void max_ticks(void * p_context, stream_id_t stream, uint64_t ticks,
+                      uint16_t seq, const int32_t * p_values, uint8_t count)
+{
+    uint64_t * p_max = p_context;
+    if (ticks > *p_max) {
+        *p_max = ticks;
+    }
+}
+
+static void place_sample(void * p_context, stream_id_t stream, uint64_t ticks,
+                         uint16_t seq, const int32_t * p_values, uint8_t count)
+{
+    place_ctx_t * p_ctx = p_context;
+    int64_t t;
+    if (stream >= STREAM_COUNT) {
+        return;
+    }
+    if (!p_ctx->p_clock->live || !time_sync_to_host(&p_ctx->p_clock->sync, ticks, &t)) {
+        t = p_ctx->p_clock->offset_ns + ticks_to_ns(ticks);
+    }
+    p_ctx->handler(p_ctx->p_context, stream, t, p_values, count);
+}
+
+void sample_clock_put(sample_clock_t * p_clock, const ingest_record_t * p_record,
+                      sample_handler_t handler, void * p_context)
+{
+    int64_t sent_ns;
+    uint64_t sync_ticks;
+    if (p_record->kind == INGEST_RECORD_TEXT && p_clock->live &&
+        time_sync_parse(p_record->p_data, p_record->len, &sent_ns, &sync_ticks))
+    {
+        time_sync_add(&p_clock->sync, sent_ns, (int64_t)p_record->host_ns, sync_ticks);
+        return;
+    }
+    if (p_record->kind != INGEST_RECORD_FRAME || p_record->len < STREAM_FRAME_HEADER_LEN ||
+        p_record->p_data[0] != STREAM_FRAME_SAMPLES)
+    {
+        return;
+    }
+    stream_frame_t frame = {
+        .type      = p_record->p_data[0],
+        .frame_seq = p_record->p_data[1],
+        .p_payload = &p_record->p_data[STREAM_FRAME_HEADER_LEN],
+        .len       = p_record->len - STREAM_FRAME_HEADER_LEN,
+    };
+
+    // First pass: the newest sample bounds the offset from above
+    uint64_t newest = 0;
+    if (!stream_samples_decode(&frame, max_ticks, &newest)) {
+        ++p_clock->bad_frames;
+        return;
+    }
+    int64_t candidate = (int64_t)p_record->host_ns - ticks_to_ns(newest);
+    if (!p_clock->valid) {
+        p_clock->offset_ns = candidate;
+        p_clock->valid = true;
+    }
+    else if (newest < p_clock->last_ticks) {
+        ++p_clock->resets;
+        time_sync_restart(&p_clock->sync, newest);
+        p_clock->offset_ns = p_clock->live
+                           ? candidate
+                           : p_clock->offset_ns + ticks_to_ns(p_clock->last_ticks);
+    }
+    else if (p_clock->live) {
+        int64_t elapsed = (int64_t)(p_record->host_ns - p_clock->last_host_ns);
+        p_clock->offset_ns += elapsed / (1000000 / SAMPLE_CLOCK_SLEW_PPM);
+        if (candidate < p_clock->offset_ns) {
+            p_clock->offset_ns = candidate;
+        }
+    }
+    p_clock->last_ticks = newest;
+    p_clock->last_host_ns = p_record->host_ns;
+
+    place_ctx_t ctx = { .p_clock = p_clock, .handler = handler, .p_context = p_context };
+    stream_samples_decode(&frame, place_sample, &ctx);
+    ++p_clock->frames;
+}
@@ -0,0 +1,81 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef SAMPLE_CLOCK_H
+#define SAMPLE_CLOCK_H
+
+/**@file
+ *
+ * @brief    Places the samples of ingest records on the host clock.
+ *
+ * @details  Samples carry the gateway's RTC ticks. A frame is stamped when it is read, some
+ *           time after its last sample, so the offset from gateway to host time follows the
+ *           smallest (host_ns - sample time) seen, leaking upward by SAMPLE_CLOCK_SLEW_PPM so
+ *           clock drift cannot pin it to an old minimum. The offset restarts when the ticks go
+ *           backwards, i.e. the gateway was reset.
+ *
+ *           When the host exchanges sync commands with the gateway (time_sync.h), the answers
+ *           in the text records give a mapping with a known error bound that also corrects the
+ *           drift of the gateway's crystal. Samples are placed by that mapping once the first
+ *           answer of the gateway's current run has arrived, and by the offset before.
+ *
+ *           A replayed capture is read far faster than it was sent, so its host stamps say
+ *           nothing about when the samples were taken. Without live timing the offset is
+ *           fixed by the first frame, sync answers are ignored, and after a gateway reset the
+ *           new samples continue from the last one.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ingest_log.h"
+#include "stream_codec.h"
+#include "time_sync.h"
+
+#define SAMPLE_CLOCK_SLEW_PPM       100
+
+/**@brief   Callback for each sample, with its time in host nanoseconds since the epoch. */
+typedef void (* sample_handler_t)(void * p_context, stream_id_t stream, int64_t t,
+                                  const int32_t * p_values, uint8_t count);
+
+typedef struct
+{
+    bool                live;                   // Host stamps reflect when frames were sent
+    bool                valid;
+    int64_t             offset_ns;              // Host time minus gateway time
+    uint64_t            last_ticks;
+    uint64_t            last_host_ns;
+    time_sync_t         sync;
+
+    uint64_t            frames;
+    uint64_t            bad_frames;             // SAMPLES frames that did not decode to the end
+    uint64_t            resets;                 // Gateway clock restarts
+} sample_clock_t;
+
+/**@brief   Reset the clock.
+ *
+ * @param[in] live    Records were stamped as they arrived, rather than replayed from a capture.
+ */
+void sample_clock_init(sample_clock_t * p_clock, bool live);
+
+/**@brief   Decode a record's samples and pass them to handler in host time.
+ *
+ * @details Sync answers update the mapping; other text records and frames other than
+ *          SAMPLES are ignored.
+ */
+void sample_clock_put(sample_clock_t * p_clock, const ingest_record_t * p_record,
+                      sample_handler_t handler, void * p_context);
+
+#endif // SAMPLE_CLOCK_H
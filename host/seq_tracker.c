@@ -0,0 +1,86 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <string.h>
+
+#include "seq_tracker.h"
+
+void seq_tracker_init(seq_tracker_t * p_tracker)
+{
+    memset(p_tracker, 0, sizeof(*p_tracker));
+}
+
+static void on_sample(void * p_context, stream_id_t stream, uint64_t ticks,
+                      uint16_t seq, const int32_t * p_values, uint8_t count)
+{
+    seq_tracker_t * p_tracker = p_context;
+    seq_stream_t * p_stream = &p_tracker->streams[stream];
+
+    if (p_stream->valid && ticks < p_stream->last_ticks) {
+        ++p_stream->resets;
+    }
+    else if (p_stream->valid) {
+        uint16_t jump = (uint16_t)(seq - p_stream->next_seq);
+        if (p_stream->gap_pending) {
+            p_stream->lost += jump;
+        }
+        else {
+            p_stream->withheld += jump;
+        }
+    }
+    p_stream->valid = true;
+    p_stream->next_seq = seq + 1;
+    p_stream->last_ticks = ticks;
+    p_stream->gap_pending = false;
+    ++p_stream->received;
+}
+
+void seq_tracker_put(seq_tracker_t * p_tracker, const ingest_record_t * p_record)
+{
+    if (p_record->kind != INGEST_RECORD_FRAME || p_record->len < STREAM_FRAME_HEADER_LEN) {
+        return;
+    }
+    stream_frame_t frame = {
+        .type      = p_record->p_data[0],
+        .frame_seq = p_record->p_data[1],
+        .p_payload = &p_record->p_data[STREAM_FRAME_HEADER_LEN],
+        .len       = p_record->len - STREAM_FRAME_HEADER_LEN,
+    };
+
+    // A lost alert or log frame hides no samples
+    if (stream_frame_seq_space(frame.type) != STREAM_SEQ_FRAMES) {
+        return;
+    }
+    if (p_tracker->frame_valid && frame.frame_seq != (uint8_t)(p_tracker->last_frame_seq + 1)) {
+        for (uint8_t stream = 0; stream < STREAM_COUNT; ++stream) {
+            p_tracker->streams[stream].gap_pending = true;
+        }
+    }
+    p_tracker->frame_valid = true;
+    p_tracker->last_frame_seq = frame.frame_seq;
+    if (frame.type != STREAM_FRAME_SAMPLES) {
+        return;
+    }
+
+    if (!stream_samples_decode(&frame, on_sample, p_tracker)) {
+        ++p_tracker->bad_frames;
+    }
+}
+
+double seq_tracker_loss_rate(const seq_stream_t * p_stream)
+{
+    uint64_t sent = p_stream->received + p_stream->lost;
+    return sent ? (double)p_stream->lost / sent : 0.0;
+}
@@ -0,0 +1,77 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef SEQ_TRACKER_H
+#define SEQ_TRACKER_H
+
+/**@file
+ *
+ * @brief    Loss accounting from the sample sequence numbers of the compressed output.
+ *
+ * @details  The gateway numbers the notifications of each stream as they are received, so
+ *           every sample that does not arrive leaves a jump in its stream's numbers, and when
+ *           the jump happened tells who lost it. If no frame went missing since the stream's previous
+ *           sample, the gateway withheld the samples itself (a dead-band rule, a payload that
+ *           did not decode). A jump across missing frames is counted as lost on the way,
+ *           although the missing frames may also have held withheld samples.
+ *
+ *           Notifications the gateway never received have no number; a silent sensor shows as
+ *           a gap in the sample times with no jump in the numbers.
+ *
+ *           A gateway reset restarts both its clock and the numbers. The first sample after a
+ *           reset, seen by its time going backwards, starts the count again.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ingest_log.h"
+#include "stream_codec.h"
+
+/**@brief Counters of one stream. */
+typedef struct
+{
+    bool                valid;
+    uint16_t            next_seq;
+    uint64_t            last_ticks;
+    bool                gap_pending;            // Frames went missing since the previous sample
+
+    uint64_t            received;
+    uint64_t            withheld;               // Skipped by the gateway
+    uint64_t            lost;                   // Skipped across missing frames
+    uint64_t            resets;                 // Gateway restarts
+} seq_stream_t;
+
+typedef struct
+{
+    bool                frame_valid;
+    uint8_t             last_frame_seq;
+    uint64_t            bad_frames;             // SAMPLES frames that did not decode to the end
+    seq_stream_t        streams[STREAM_COUNT];
+} seq_tracker_t;
+
+/**@brief   Reset the tracker and its counters. */
+void seq_tracker_init(seq_tracker_t * p_tracker);
+
+/**@brief   Account for a record. Give it every frame, so that frame_seq gaps are seen.
+ *
+ * @details Text records are ignored.
+ */
+void seq_tracker_put(seq_tracker_t * p_tracker, const ingest_record_t * p_record);
+
+/**@brief   Fraction of the stream's samples lost on the way, 0 before any sample. */
+double seq_tracker_loss_rate(const seq_stream_t * p_stream);
+
+#endif // SEQ_TRACKER_H
@@ -0,0 +1,287 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Level-of-detail feed of the gateway's samples for live plots.
+ *
+ * @details  Follows an ingest log as st_ingestd appends to it and keeps a min/max pyramid
+ *           (lod_pyramid.h) per channel. Every interval it prints, per channel, the last
+ *           window decimated to at most the requested number of buckets: time, min, max and
+ *           mean, scaled as in sensortag_payload.c, one CSV block per channel separated by a
+ *           blank line. Hours of 10 Hz data thus reach the plot as a few thousand points
+ *           that still show every peak.
+ *
+ *           -s first loads a column store's history into the pyramids and then follows the
+ *           log from its end, since st_ingestd -s has already stored what the log holds. -1
+ *           reads the log once, prints one view and exits. -r marks the log as a replayed
+ *           capture (see sample_clock.h).
+ *
+ *           usage: st_feed [-w window_s] [-n buckets] [-i interval_ms] [-c channel]
+ *                          [-s store] [-1] [-r] <log.stlog>
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "column_store.h"
+#include "ingest_log.h"
+#include "lod_pyramid.h"
+#include "sample_clock.h"
+#include "sensortag_payload.h"
+#include "store_writer.h"
+
+#define DEFAULT_WINDOW_S        3600
+#define DEFAULT_BUCKETS         2000
+#define DEFAULT_INTERVAL_MS     500
+#define READ_BUFFER             (1024 * 1024)
+
+typedef struct
+{
+    char                name[COLUMN_NAME_MAX];
+    float               scale;
+    int64_t             last_t;
+    lod_pyramid_t       pyramid;
+} feed_channel_t;
+
+static feed_channel_t m_channels[STREAM_COUNT][STREAM_MAX_VALUES];
+static uint64_t m_samples;                      // Values added, over all channels
+static uint64_t m_log_samples;                  // ... of which came from the log
+static double m_put_seconds;
+
+static double monotonic_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(const char * p_name)
+{
+    fprintf(stderr, "usage: %s [-w window_s] [-n buckets] [-i interval_ms] [-c channel]\n"
+                    "       %*s [-s store] [-1] [-r] <log.stlog>\n", p_name, (int)strlen(p_name), "");
+}
+
+static void channel_put(feed_channel_t * p_channel, int64_t t, int32_t v)
+{
+    // Keep time order if the clock offset moved back
+    if (t < p_channel->last_t) {
+        t = p_channel->last_t;
+    }
+    p_channel->last_t = t;
+    lod_put(&p_channel->pyramid, t, v);
+}
+
+static void on_sample(void * p_context, stream_id_t stream, int64_t t,
+                      const int32_t * p_values, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; ++i) {
+        channel_put(&m_channels[stream][i], t, p_values[i]);
+    }
+    m_samples += count;
+    m_log_samples += count;
+}
+
+static void seed_sample(void * p_context, int64_t t, int32_t v)
+{
+    channel_put(p_context, t, v);
+}
+
+static int seed_from_store(const char * p_root)
+{
+    column_store_t store;
+    if (column_store_open(&store, p_root, false) != 0) {
+        return -1;
+    }
+    for (int stream = 0; stream < STREAM_COUNT; ++stream) {
+        for (uint8_t i = 0; i < st_payload_def(stream)->value_count; ++i) {
+            feed_channel_t * p_channel = &m_channels[stream][i];
+            const column_channel_t * p_column = column_store_channel(&store, p_channel->name, false);
+            if (p_column != NULL) {
+                m_samples += column_scan(p_column, INT64_MIN, INT64_MAX, seed_sample, p_channel);
+            }
+        }
+    }
+    column_store_close(&store);
+    return 0;
+}
+
+static void print_view(int64_t window_ns, size_t max_buckets, const char * p_only)
+{
+    static lod_bucket_t buckets[LOD_LEVEL_BUCKETS];
+    if (max_buckets > LOD_LEVEL_BUCKETS) {
+        max_buckets = LOD_LEVEL_BUCKETS;
+    }
+    for (int stream = 0; stream < STREAM_COUNT; ++stream) {
+        for (uint8_t i = 0; i < st_payload_def(stream)->value_count; ++i) {
+            const feed_channel_t * p_channel = &m_channels[stream][i];
+            if ((p_only && strcmp(p_only, p_channel->name) != 0) || p_channel->pyramid.samples == 0) {
+                continue;
+            }
+            uint8_t level;
+            double start = monotonic_s();
+            size_t count = lod_query(&p_channel->pyramid, p_channel->last_t - window_ns,
+                                     p_channel->last_t + 1, buckets, max_buckets, &level);
+            double elapsed = monotonic_s() - start;
+
+            printf("# %s: %zu buckets of %.1f s (level %u) from %llu samples, %.0f us\n",
+                   p_channel->name, count, p_channel->pyramid.levels[level].width * 1e-9, level,
+                   (unsigned long long)p_channel->pyramid.samples, elapsed * 1e6);
+            printf("# t,min,max,mean\n");
+            for (size_t b = 0; b < count; ++b) {
+                printf("%.3f,%g,%g,%g\n", buckets[b].t_start * 1e-9,
+                       p_channel->scale * buckets[b].min, p_channel->scale * buckets[b].max,
+                       p_channel->scale * (double)buckets[b].sum / buckets[b].count);
+            }
+            printf("\n");
+        }
+    }
+    fflush(stdout);
+}
+
+/**@brief Consume the whole records in p_buf; returns the bytes used. */
+static size_t parse_records(sample_clock_t * p_clock, const uint8_t * p_buf, size_t len, bool * p_damaged)
+{
+    size_t pos = 0;
+    ingest_record_t record;
+    while (len - pos >= INGEST_RECORD_HEADER_LEN) {
+        if (!ingest_record_header_unpack(&p_buf[pos], &record)) {
+            *p_damaged = true;
+            return pos;
+        }
+        if (len - pos - INGEST_RECORD_HEADER_LEN < record.len) {
+            break;
+        }
+        record.p_data = &p_buf[pos + INGEST_RECORD_HEADER_LEN];
+        double start = monotonic_s();
+        sample_clock_put(p_clock, &record, on_sample, NULL);
+        m_put_seconds += monotonic_s() - start;
+        pos += INGEST_RECORD_HEADER_LEN + record.len;
+    }
+    return pos;
+}
+
+int main(int argc, char ** argv)
+{
+    int64_t window_ns = DEFAULT_WINDOW_S * 1000000000LL;
+    size_t max_buckets = DEFAULT_BUCKETS;
+    long interval_ms = DEFAULT_INTERVAL_MS;
+    const char * p_only = NULL;
+    const char * p_store = NULL;
+    bool once = false;
+    bool live = true;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:n:i:c:s:1r")) != -1) {
+        switch (opt) {
+            case 'w': window_ns = (int64_t)(strtod(optarg, NULL) * 1e9); break;
+            case 'n': max_buckets = strtoul(optarg, NULL, 10); break;
+            case 'i': interval_ms = strtol(optarg, NULL, 10); break;
+            case 'c': p_only = optarg; break;
+            case 's': p_store = optarg; break;
+            case '1': once = true; break;
+            case 'r': live = false; break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind + 1 != argc || max_buckets == 0 || interval_ms <= 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int stream = 0; stream < STREAM_COUNT; ++stream) {
+        for (uint8_t i = 0; i < st_payload_def(stream)->value_count; ++i) {
+            feed_channel_t * p_channel = &m_channels[stream][i];
+            store_channel_name(stream, i, p_channel->name, sizeof(p_channel->name));
+            p_channel->scale = st_payload_def(stream)->scale;
+            p_channel->last_t = INT64_MIN;
+            lod_init(&p_channel->pyramid);
+        }
+    }
+
+    const char * p_path = argv[optind];
+    int fd = open(p_path, O_RDONLY | O_CLOEXEC);
+    uint8_t header[INGEST_LOG_HEADER_LEN];
+    if (fd < 0 || read(fd, header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, INGEST_LOG_MAGIC, sizeof(INGEST_LOG_MAGIC) - 1) != 0)
+    {
+        fprintf(stderr, "%s: not an ingest log\n", p_path);
+        return EXIT_FAILURE;
+    }
+
+    double start = monotonic_s();
+    if (p_store != NULL) {
+        if (seed_from_store(p_store) != 0) {
+            return EXIT_FAILURE;
+        }
+        // The store already holds what the log does: only follow new records
+        lseek(fd, 0, SEEK_END);
+    }
+    double seeded = monotonic_s() - start;
+
+    sample_clock_t clock;
+    sample_clock_init(&clock, live);
+    uint8_t * p_buf = malloc(READ_BUFFER);
+    size_t fill = 0;
+    bool damaged = false;
+    double next_view = monotonic_s();
+    while (!damaged) {
+        ssize_t n = read(fd, &p_buf[fill], READ_BUFFER - fill);
+        if (n < 0 && errno != EINTR) {
+            perror(p_path);
+            break;
+        }
+        if (n > 0) {
+            fill += n;
+            size_t used = parse_records(&clock, p_buf, fill, &damaged);
+            memmove(p_buf, &p_buf[used], fill - used);
+            fill -= used;
+            continue;
+        }
+        if (once) {
+            break;
+        }
+        if (monotonic_s() >= next_view) {
+            print_view(window_ns, max_buckets, p_only);
+            next_view = monotonic_s() + interval_ms * 1e-3;
+        }
+        // At the end of the log: wait for st_ingestd to append more
+        struct timespec pause = { .tv_nsec = 20 * 1000000L };
+        nanosleep(&pause, NULL);
+    }
+    if (damaged) {
+        fprintf(stderr, "%s: damaged record, stopping\n", p_path);
+    }
+    print_view(window_ns, max_buckets, p_only);
+
+    fprintf(stderr, "%llu values", (unsigned long long)m_samples);
+    if (p_store != NULL) {
+        fprintf(stderr, ", %llu from the store in %.3f s", (unsigned long long)(m_samples - m_log_samples), seeded);
+    }
+    if (m_log_samples > 0) {
+        fprintf(stderr, ", %.1f ns each to decode from the log and add to the pyramids",
+                m_put_seconds * 1e9 / m_log_samples);
+    }
+    fprintf(stderr, "\n");
+    free(p_buf);
+    close(fd);
+    return damaged ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,441 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Ingest daemon for the gateway output stream.
+ *
+ * @details  Reads the gateway's UART output from a serial port, a pty or a capture file,
+ *           splits it into frames and text lines (ingest_parser.c), stamps each record with
+ *           the host time it was read, publishes it to an in-memory ring and appends it to an
+ *           on-disk log (ingest_log.h) from a separate writer thread, so a slow disk never
+ *           holds up the reader.
+ *
+ *           A serial port is switched to raw mode at the given baud rate and read until
+ *           SIGINT/SIGTERM; records that do not fit the ring are dropped and counted, since the
+ *           port cannot be paused. Any other input is a replay: it is read in large blocks as
+ *           fast as the disk allows, the reader waits for the writer instead of dropping, and
+ *           the daemon exits at end of file. Throughput and stream health are reported on exit.
+ *
+ *           -s also appends the samples to a column store (column_store.h), as
+ *           st_store import would from the log. The sample sequence numbers are checked as
+ *           frames arrive (seq_tracker.h), and the loss of each stream is reported on exit.
+ *
+ *           On a serial port given by name, a sync command is sent every -y seconds (default
+ *           DEFAULT_SYNC_S, 0 for none). The answers are logged like any other text, so the
+ *           store and st_store import place samples on the host clock through them
+ *           (time_sync.h); they are not echoed.
+ *
+ *           -d prints the gateway's tokenized diagnostics, the log frames of compressed mode, as
+ *           text from the dictionary of its build (log_dict.h). They are echoed with the other text
+ *           lines, also on a replay unless -q is given; the log keeps them as they arrived.
+ *
+ *           usage: st_ingestd [-b baud] [-o log] [-s store] [-y sync_s] [-d dict] [-q] <tty|pty|capture|->
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ingest_log.h"
+#include "ingest_parser.h"
+#include "ingest_ring.h"
+#include "log_dict.h"
+#include "sensortag_payload.h"
+#include "seq_tracker.h"
+#include "store_writer.h"
+#include "time_sync.h"
+
+#define DEFAULT_BAUD            115200                          /**< Matches UART_BAUD */
+#define DEFAULT_LOG             "st_ingest.stlog"
+#define DEFAULT_SYNC_S          10
+#define LOG_TEXT_MAX            256                             /**< Longest diagnostic printed from the dictionary. */
+#define SYNC_POLL_MS            100                             /**< How often the sync thread checks for shutdown. */
+#define READ_CHUNK              (256 * 1024)
+#define RING_SIZE               (8 * 1024 * 1024)
+
+typedef struct
+{
+    ingest_ring_t       ring;
+    uint64_t            host_ns;                // Stamp for the records of the current read
+    bool                block;
+    bool                echo;                   // Print text lines to stdout
+    store_writer_t      *p_store_writer;        // Optional
+    seq_tracker_t       seq_tracker;
+    time_sync_t         time_sync;              // Live only: replayed stamps say nothing about the exchanges
+    unsigned            sync_acks;              // [CMD] ok replies to sync commands still to be hidden
+    log_dict_t          *p_log_dict;            // Optional
+} ingest_ctx_t;
+
+typedef struct
+{
+    int                 fd;
+    unsigned            interval_s;
+    uint64_t            sent;
+} sync_ctx_t;
+
+typedef struct
+{
+    ingest_ring_t       *p_ring;
+    int                 fd;
+    uint64_t            written;
+    int                 result;
+} writer_ctx_t;
+
+static volatile sig_atomic_t m_stop;
+
+static void on_signal(int sig)
+{
+    m_stop = 1;
+}
+
+static uint64_t realtime_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static double monotonic_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static speed_t baud_to_speed(long baud)
+{
+    switch (baud) {
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        default:      return B0;
+    }
+}
+
+static int tty_configure(int fd, long baud)
+{
+    speed_t speed = baud_to_speed(baud);
+    if (speed == B0) {
+        fprintf(stderr, "unsupported baud rate %ld\n", baud);
+        return -1;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        perror("tcgetattr");
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~CRTSCTS;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror("tcsetattr");
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+    return 0;
+}
+
+static void print_log(const ingest_ctx_t * p_ctx, const stream_log_t * p_log)
+{
+    if (p_ctx->echo) {
+        char text[LOG_TEXT_MAX];
+        log_dict_format(p_ctx->p_log_dict, p_log, text, sizeof(text));
+        printf("%s\n", text);
+    }
+}
+
+static void print_log_frame(const ingest_ctx_t * p_ctx, const uint8_t * p_data, uint16_t len)
+{
+    if (p_ctx->p_log_dict == NULL || len < STREAM_FRAME_HEADER_LEN || p_data[0] != STREAM_FRAME_LOG) {
+        return;
+    }
+    const stream_frame_t frame = {
+        .type      = p_data[0],
+        .frame_seq = p_data[1],
+        .p_payload = &p_data[STREAM_FRAME_HEADER_LEN],
+        .len       = len - STREAM_FRAME_HEADER_LEN,
+    };
+    stream_log_t log;
+    if (stream_log_decode(&frame, &log)) {
+        print_log(p_ctx, &log);
+    }
+}
+
+static void on_record(void * p_context, uint8_t kind, const uint8_t * p_data, uint16_t len)
+{
+    ingest_ctx_t * p_ctx = p_context;
+    ingest_ring_publish(&p_ctx->ring, p_ctx->host_ns, kind, p_data, len, p_ctx->block);
+    ingest_record_t record = { .host_ns = p_ctx->host_ns, .kind = kind, .len = len, .p_data = p_data };
+    seq_tracker_put(&p_ctx->seq_tracker, &record);
+    if (p_ctx->p_store_writer != NULL) {
+        store_writer_put(p_ctx->p_store_writer, &record);
+    }
+    if (kind != INGEST_RECORD_TEXT) {
+        print_log_frame(p_ctx, p_data, len);
+        return;
+    }
+
+    int64_t sent_ns;
+    uint64_t ticks;
+    if (!p_ctx->block && time_sync_parse(p_data, len, &sent_ns, &ticks)) {
+        time_sync_add(&p_ctx->time_sync, sent_ns, (int64_t)p_ctx->host_ns, ticks);
+        ++p_ctx->sync_acks;
+        return;
+    }
+    if (p_ctx->sync_acks > 0 && len == 8 && memcmp(p_data, "[CMD] ok", 8) == 0) {
+        --p_ctx->sync_acks;
+        return;
+    }
+    if (p_ctx->echo) {
+        printf("%.*s\n", (int)len, (const char *)p_data);
+    }
+}
+
+/**@brief Send a sync command every interval until shutdown. */
+static void * sync_thread(void * p_arg)
+{
+    sync_ctx_t * p_sync = p_arg;
+    unsigned waited_ms = p_sync->interval_s * 1000;
+    while (!m_stop) {
+        if (waited_ms >= p_sync->interval_s * 1000) {
+            char request[48];
+            int len = time_sync_request((int64_t)realtime_ns(), request, sizeof(request));
+            if (write(p_sync->fd, request, len) == len) {
+                ++p_sync->sent;
+            }
+            waited_ms = 0;
+        }
+        struct timespec ts = { .tv_nsec = SYNC_POLL_MS * 1000000L };
+        nanosleep(&ts, NULL);
+        waited_ms += SYNC_POLL_MS;
+    }
+    return NULL;
+}
+
+static void * writer_thread(void * p_arg)
+{
+    writer_ctx_t * p_writer = p_arg;
+    const uint8_t * p_data;
+    size_t len;
+    while ((len = ingest_ring_peek(p_writer->p_ring, &p_data)) > 0) {
+        if (p_writer->result == 0 && ingest_log_write(p_writer->fd, p_data, len) != 0) {
+            // Keep draining so the reader is never stuck behind a dead disk
+            p_writer->result = -1;
+        }
+        p_writer->written += len;
+        ingest_ring_consume(p_writer->p_ring, len);
+    }
+    return NULL;
+}
+
+static int open_input(const char * p_path, long baud, bool * p_live)
+{
+    if (strcmp(p_path, "-") == 0) {
+        *p_live = isatty(STDIN_FILENO);
+        return STDIN_FILENO;
+    }
+    int fd = open(p_path, O_RDONLY | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(p_path);
+        return -1;
+    }
+    *p_live = isatty(fd);
+    if (*p_live && tty_configure(fd, baud) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char ** argv)
+{
+    long baud = DEFAULT_BAUD;
+    const char * p_log_path = DEFAULT_LOG;
+    const char * p_store_path = NULL;
+    const char * p_dict_path = NULL;
+    bool quiet = false;
+    unsigned sync_s = DEFAULT_SYNC_S;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:o:s:y:d:q")) != -1) {
+        switch (opt) {
+            case 'b': baud = strtol(optarg, NULL, 10); break;
+            case 'o': p_log_path = optarg; break;
+            case 's': p_store_path = optarg; break;
+            case 'y': sync_s = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'd': p_dict_path = optarg; break;
+            case 'q': quiet = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-b baud] [-o log] [-s store] [-y sync_s] [-d dict] [-q] <tty|pty|capture|->\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind + 1 != argc) {
+        fprintf(stderr, "usage: %s [-b baud] [-o log] [-s store] [-y sync_s] [-d dict] [-q] <tty|pty|capture|->\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bool live;
+    int in_fd = open_input(argv[optind], baud, &live);
+    if (in_fd < 0) {
+        return EXIT_FAILURE;
+    }
+    int log_fd = ingest_log_open(p_log_path);
+    if (log_fd < 0) {
+        return EXIT_FAILURE;
+    }
+
+    static ingest_ctx_t ctx;
+    static log_dict_t log_dict;
+    static column_store_t store;
+    static store_writer_t store_writer;
+    if (p_store_path != NULL) {
+        if (column_store_open(&store, p_store_path, true) != 0 ||
+            store_writer_init(&store_writer, &store, live) != 0)
+        {
+            return EXIT_FAILURE;
+        }
+        ctx.p_store_writer = &store_writer;
+    }
+    if (p_dict_path != NULL) {
+        if (log_dict_load(&log_dict, p_dict_path) != 0) {
+            return EXIT_FAILURE;
+        }
+        ctx.p_log_dict = &log_dict;
+    }
+    if (ingest_ring_init(&ctx.ring, RING_SIZE) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return EXIT_FAILURE;
+    }
+    ctx.block = !live;
+    ctx.echo = (live || ctx.p_log_dict != NULL) && !quiet;
+    seq_tracker_init(&ctx.seq_tracker);
+    time_sync_init(&ctx.time_sync);
+
+    // No SA_RESTART, so a signal also ends a blocking read
+    struct sigaction sa = { .sa_handler = on_signal };
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    writer_ctx_t writer = { .p_ring = &ctx.ring, .fd = log_fd };
+    pthread_t writer_tid;
+    pthread_create(&writer_tid, NULL, writer_thread, &writer);
+
+    // The port is opened again for writing, so the reader keeps its own descriptor
+    sync_ctx_t sync = { .fd = -1, .interval_s = sync_s };
+    pthread_t sync_tid;
+    if (live && sync_s > 0 && in_fd != STDIN_FILENO) {
+        sync.fd = open(argv[optind], O_WRONLY | O_NOCTTY | O_CLOEXEC);
+        if (sync.fd < 0) {
+            perror(argv[optind]);
+        }
+        else {
+            pthread_create(&sync_tid, NULL, sync_thread, &sync);
+        }
+    }
+
+    ingest_parser_t parser;
+    ingest_parser_init(&parser, on_record, &ctx);
+
+    uint8_t * p_buf = malloc(READ_CHUNK);
+    double start = monotonic_s();
+    while (!m_stop) {
+        ssize_t n = read(in_fd, p_buf, READ_CHUNK);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            // End of a capture, or EIO once the other side of a pty has closed
+            if (n < 0 && errno != EIO) {
+                perror("read");
+            }
+            break;
+        }
+        ctx.host_ns = realtime_ns();
+        ingest_parser_feed(&parser, p_buf, (size_t)n);
+        if (ctx.echo) {
+            fflush(stdout);
+        }
+    }
+    ctx.host_ns = realtime_ns();
+    ingest_parser_flush(&parser);
+    if (sync.fd >= 0) {
+        m_stop = 1;
+        pthread_join(sync_tid, NULL);
+        close(sync.fd);
+    }
+
+    ingest_ring_close(&ctx.ring);
+    pthread_join(writer_tid, NULL);
+    double elapsed = monotonic_s() - start;
+    if (fsync(log_fd) != 0 && errno != EINVAL) {
+        perror("fsync");
+        writer.result = -1;
+    }
+    close(log_fd);
+    if (in_fd != STDIN_FILENO) {
+        close(in_fd);
+    }
+
+    fprintf(stderr, "%s: %llu bytes in %.3f s (%.1f MB/s)\n", argv[optind],
+            (unsigned long long)parser.bytes, elapsed, parser.bytes / elapsed / 1e6);
+    fprintf(stderr, "  frames            %llu (%.0f/s), %llu missing by frame_seq\n",
+            (unsigned long long)parser.frames, parser.frames / elapsed,
+            (unsigned long long)parser.seq_gaps);
+    fprintf(stderr, "  text lines        %llu\n", (unsigned long long)parser.lines);
+    for (uint8_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        const seq_stream_t * p_stream = &ctx.seq_tracker.streams[stream];
+        fprintf(stderr, "  %-17s %llu samples, %llu lost (%.2f%%), %llu withheld by the gateway, %llu resets\n",
+                st_payload_def(stream)->name, (unsigned long long)p_stream->received,
+                (unsigned long long)p_stream->lost, 100.0 * seq_tracker_loss_rate(p_stream),
+                (unsigned long long)p_stream->withheld, (unsigned long long)p_stream->resets);
+    }
+    if (sync.fd >= 0) {
+        fprintf(stderr, "  time sync         %llu sent, %llu answered, drift %.2f ppm, error %.3f ms, %llu resets\n",
+                (unsigned long long)sync.sent, (unsigned long long)ctx.time_sync.accepted,
+                time_sync_drift_ppm(&ctx.time_sync), ctx.time_sync.error_ns / 1e6,
+                (unsigned long long)ctx.time_sync.resets);
+    }
+    fprintf(stderr, "  records           %llu logged, %llu dropped (ring full)\n",
+            (unsigned long long)ctx.ring.records, (unsigned long long)ctx.ring.dropped);
+    fprintf(stderr, "  log               %s, %llu bytes appended\n", p_log_path,
+            (unsigned long long)writer.written);
+
+    if (ctx.p_store_writer != NULL) {
+        fprintf(stderr, "  store             %s, %llu samples\n", p_store_path,
+                (unsigned long long)store_writer.samples);
+        column_store_close(&store);
+    }
+
+    free(p_buf);
+    log_dict_free(&log_dict);
+    ingest_ring_free(&ctx.ring);
+    return writer.result ? EXIT_FAILURE : EXIT_SUCCESS;
+}
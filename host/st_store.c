@@ -0,0 +1,221 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+/**@file
+ *
+ * @brief    Import, inspect and query a column store of captured samples.
+ *
+ * @details  import reads ingest logs (st_ingestd) into the store; st_ingestd -s writes the
+ *           same store live. Logs of replayed captures need -r, since their host stamps are
+ *           replay times (see sample_clock.h). info lists the channels. query downsamples a channel into
+ *           buckets of min, mean and max; dump prints its raw samples. Times are Unix seconds;
+ *           values are scaled as defined in sensortag_payload.c.
+ *
+ *           usage: st_store import [-r] <store> <log.stlog ...>
+ *                  st_store info <store>
+ *                  st_store query [-n buckets] <store> <channel> [from to]
+ *                  st_store dump <store> <channel> [from to]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "column_store.h"
+#include "ingest_log.h"
+#include "sensortag_payload.h"
+#include "store_writer.h"
+
+#define DEFAULT_BUCKETS         1000
+
+static void usage(const char * p_name)
+{
+    fprintf(stderr, "usage: %s import [-r] <store> <log.stlog ...>\n"
+                    "       %s info <store>\n"
+                    "       %s query [-n buckets] <store> <channel> [from to]\n"
+                    "       %s dump <store> <channel> [from to]\n",
+            p_name, p_name, p_name, p_name);
+}
+
+static double monotonic_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**@brief Scale of a channel's raw values, from the stream part of its name. */
+static float channel_scale(const char * p_channel)
+{
+    char stream_name[COLUMN_NAME_MAX];
+    snprintf(stream_name, sizeof(stream_name), "%.*s",
+             (int)strcspn(p_channel, "."), p_channel);
+    const st_payload_def_t * p_def = st_payload_def(st_payload_find(stream_name));
+    return p_def ? p_def->scale : 1.0f;
+}
+
+static int cmd_import(const char * p_root, char ** pp_logs, int count, bool live)
+{
+    column_store_t store;
+    store_writer_t writer;
+    if (column_store_open(&store, p_root, true) != 0 || store_writer_init(&writer, &store, live) != 0) {
+        return -1;
+    }
+
+    double start = monotonic_s();
+    uint64_t records = 0;
+    for (int i = 0; i < count; ++i) {
+        ingest_log_reader_t reader;
+        if (ingest_log_reader_open(&reader, pp_logs[i]) != 0) {
+            continue;
+        }
+        ingest_record_t record;
+        while (ingest_log_reader_next(&reader, &record)) {
+            store_writer_put(&writer, &record);
+            ++records;
+        }
+        if (reader.pos != reader.size) {
+            fprintf(stderr, "%s: stopped at a damaged record, offset %zu\n", pp_logs[i], reader.pos);
+        }
+        ingest_log_reader_close(&reader);
+    }
+    column_store_close(&store);
+
+    double elapsed = monotonic_s() - start;
+    fprintf(stderr, "%llu records, %llu frames, %llu samples in %.3f s (%.0f samples/s)\n",
+            (unsigned long long)records, (unsigned long long)writer.clock.frames,
+            (unsigned long long)writer.samples, elapsed, writer.samples / elapsed);
+    fprintf(stderr, "%llu bad frames, %llu gateway resets, %llu samples reordered\n",
+            (unsigned long long)writer.clock.bad_frames, (unsigned long long)writer.clock.resets,
+            (unsigned long long)writer.reordered);
+    return 0;
+}
+
+static int cmd_info(const char * p_root)
+{
+    column_store_t store;
+    if (column_store_open(&store, p_root, false) != 0) {
+        return -1;
+    }
+    for (size_t c = 0; c < store.channel_count; ++c) {
+        const column_channel_t * p_channel = &store.channels[c];
+        int64_t first = 0;
+        int64_t last = 0;
+        column_time_range(p_channel, &first, &last);
+        printf("%-12s %10llu samples  %3zu segments  %.3f .. %.3f\n", p_channel->name,
+               (unsigned long long)column_count(p_channel), p_channel->segment_count,
+               first * 1e-9, last * 1e-9);
+    }
+    column_store_close(&store);
+    return 0;
+}
+
+static void print_sample(void * p_context, int64_t t, int32_t v)
+{
+    float scale = *(const float *)p_context;
+    printf("%.6f,%g\n", t * 1e-9, scale * v);
+}
+
+static int cmd_read(const char * p_root, const char * p_name, char ** pp_range, int range_count,
+                    size_t buckets)
+{
+    column_store_t store;
+    if (column_store_open(&store, p_root, false) != 0) {
+        return -1;
+    }
+    const column_channel_t * p_channel = column_store_channel(&store, p_name, false);
+    int64_t t0;
+    int64_t t1;
+    if (p_channel == NULL || !column_time_range(p_channel, &t0, &t1)) {
+        fprintf(stderr, "%s: no such channel, or empty\n", p_name);
+        column_store_close(&store);
+        return -1;
+    }
+    t1 += 1;
+    if (range_count == 2) {
+        t0 = (int64_t)(strtod(pp_range[0], NULL) * 1e9);
+        t1 = (int64_t)(strtod(pp_range[1], NULL) * 1e9);
+    }
+
+    float scale = channel_scale(p_name);
+    double start = monotonic_s();
+    if (buckets == 0) {
+        column_scan(p_channel, t0, t1, print_sample, &scale);
+    }
+    else {
+        column_bucket_t * p_buckets = calloc(buckets, sizeof(column_bucket_t));
+        column_query(p_channel, t0, t1, p_buckets, buckets);
+        double elapsed = monotonic_s() - start;
+        printf("# t,count,min,mean,max\n");
+        for (size_t i = 0; i < buckets; ++i) {
+            const column_bucket_t * p_bucket = &p_buckets[i];
+            if (p_bucket->count > 0) {
+                printf("%.6f,%llu,%g,%g,%g\n", p_bucket->t_start * 1e-9,
+                       (unsigned long long)p_bucket->count, scale * p_bucket->min,
+                       scale * (double)p_bucket->sum / p_bucket->count, scale * p_bucket->max);
+            }
+        }
+        fprintf(stderr, "%zu buckets in %.3f ms\n", buckets, elapsed * 1e3);
+        free(p_buckets);
+    }
+    column_store_close(&store);
+    return 0;
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char * p_cmd = argv[1];
+    int result = -1;
+    if (strcmp(p_cmd, "import") == 0) {
+        bool replayed = (argc > 2 && strcmp(argv[2], "-r") == 0);
+        int first = replayed ? 3 : 2;
+        if (argc - first < 2) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        result = cmd_import(argv[first], &argv[first + 1], argc - first - 1, !replayed);
+    }
+    else if (strcmp(p_cmd, "info") == 0 && argc == 3) {
+        result = cmd_info(argv[2]);
+    }
+    else if (strcmp(p_cmd, "query") == 0 || strcmp(p_cmd, "dump") == 0) {
+        size_t buckets = (strcmp(p_cmd, "query") == 0) ? DEFAULT_BUCKETS : 0;
+        int opt;
+        optind = 2;
+        while (buckets > 0 && (opt = getopt(argc, argv, "n:")) != -1) {
+            if (opt != 'n' || (buckets = strtoul(optarg, NULL, 10)) == 0) {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        int args = argc - optind;
+        if (args == 2 || args == 4) {
+            result = cmd_read(argv[optind], argv[optind + 1], &argv[optind + 2], args - 2, buckets);
+        }
+        else {
+            usage(argv[0]);
+        }
+    }
+    else {
+        usage(argv[0]);
+    }
+    return result ? EXIT_FAILURE : EXIT_SUCCESS;
+}
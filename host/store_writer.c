@@ -0,0 +1,68 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sensortag_payload.h"
+#include "store_writer.h"
+
+void store_channel_name(stream_id_t stream, uint8_t value_index, char * p_name, size_t size)
+{
+    const st_payload_def_t * p_def = st_payload_def(stream);
+    snprintf(p_name, size, "%s.%s", p_def->name, p_def->value_names[value_index]);
+}
+
+int store_writer_init(store_writer_t * p_writer, column_store_t * p_store, bool live)
+{
+    memset(p_writer, 0, sizeof(*p_writer));
+    p_writer->p_store = p_store;
+    sample_clock_init(&p_writer->clock, live);
+    for (int stream = 0; stream < STREAM_COUNT; ++stream) {
+        for (uint8_t i = 0; i < st_payload_def(stream)->value_count; ++i) {
+            char name[COLUMN_NAME_MAX];
+            store_channel_name(stream, i, name, sizeof(name));
+            p_writer->p_channels[stream][i] = column_store_channel(p_store, name, true);
+            if (p_writer->p_channels[stream][i] == NULL) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void append_sample(void * p_context, stream_id_t stream, int64_t t,
+                          const int32_t * p_values, uint8_t count)
+{
+    store_writer_t * p_writer = p_context;
+    for (uint8_t i = 0; i < count; ++i) {
+        column_channel_t * p_channel = p_writer->p_channels[stream][i];
+        int64_t first;
+        int64_t last;
+        int64_t t_value = t;
+        if (column_time_range(p_channel, &first, &last) && t < last) {
+            // The offset estimate moved back past samples already stored
+            t_value = last;
+            ++p_writer->reordered;
+        }
+        column_append(p_channel, t_value, p_values[i]);
+    }
+    ++p_writer->samples;
+}
+
+void store_writer_put(store_writer_t * p_writer, const ingest_record_t * p_record)
+{
+    sample_clock_put(&p_writer->clock, p_record, append_sample, p_writer);
+}
@@ -0,0 +1,56 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef STORE_WRITER_H
+#define STORE_WRITER_H
+
+/**@file
+ *
+ * @brief    Moves the samples of ingest records into a column store.
+ *
+ * @details  Each value of each stream gets a channel named "<stream>.<value>" after
+ *           sensortag_payload.c, e.g. "temp.ir". Sample times come from sample_clock.h.
+ */
+
+#include <stdint.h>
+
+#include "column_store.h"
+#include "ingest_log.h"
+#include "sample_clock.h"
+#include "stream_codec.h"
+
+typedef struct
+{
+    column_store_t      *p_store;
+    column_channel_t    *p_channels[STREAM_COUNT][STREAM_MAX_VALUES];
+    sample_clock_t      clock;
+
+    uint64_t            samples;
+    uint64_t            reordered;              // Samples moved forward to keep a channel in order
+} store_writer_t;
+
+/**@brief   Create or open the channels of every stream. Returns 0 on success.
+ *
+ * @param[in] live    Records were stamped as they arrived; see sample_clock_init.
+ */
+int store_writer_init(store_writer_t * p_writer, column_store_t * p_store, bool live);
+
+/**@brief   Append the samples of a record; records other than SAMPLES frames are ignored. */
+void store_writer_put(store_writer_t * p_writer, const ingest_record_t * p_record);
+
+/**@brief   Channel name of a stream value, "<stream>.<value>". */
+void store_channel_name(stream_id_t stream, uint8_t value_index, char * p_name, size_t size);
+
+#endif // STORE_WRITER_H
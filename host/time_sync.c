@@ -0,0 +1,177 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "time_sync.h"
+
+#define SYNC_LINE_MAX           64
+
+/**@brief RTC1 ticks (32768 Hz) to nanoseconds, as a difference that may be negative. */
+static double ticks_to_ns(int64_t ticks)
+{
+    return ticks * (1e9 / 32768);
+}
+
+void time_sync_init(time_sync_t * p_sync)
+{
+    memset(p_sync, 0, sizeof(*p_sync));
+}
+
+bool time_sync_parse(const uint8_t * p_line, uint16_t len, int64_t * p_sent_ns, uint64_t * p_ticks)
+{
+    char line[SYNC_LINE_MAX];
+    if (len >= sizeof(line) || len < 7 || memcmp(p_line, "[SYNC] ", 7) != 0) {
+        return false;
+    }
+    memcpy(line, p_line, len);
+    line[len] = '\0';
+
+    unsigned long s;
+    unsigned long us;
+    unsigned long long ticks;
+    if (sscanf(line, "[SYNC] %lu %lu %llu", &s, &us, &ticks) != 3 || us >= 1000000) {
+        return false;
+    }
+    *p_sent_ns = (int64_t)s * 1000000000 + (int64_t)us * 1000;
+    *p_ticks = ticks;
+    return true;
+}
+
+static const time_sync_exchange_t * newest(const time_sync_t * p_sync)
+{
+    return &p_sync->exchanges[(p_sync->next + TIME_SYNC_WINDOW - 1) % TIME_SYNC_WINDOW];
+}
+
+static void fit(time_sync_t * p_sync)
+{
+    if (p_sync->count == 0) {
+        p_sync->valid = false;
+        return;
+    }
+    const time_sync_exchange_t * p_newest = newest(p_sync);
+    int64_t fastest = INT64_MAX;
+    for (size_t i = 0; i < p_sync->count; ++i) {
+        int64_t rtt = p_sync->exchanges[i].received_ns - p_sync->exchanges[i].sent_ns;
+        if (rtt < fastest) {
+            fastest = rtt;
+        }
+    }
+    // Coordinates relative to the newest exchange keep the doubles exact enough
+    p_sync->ref_ticks = p_newest->ticks;
+    p_sync->ref_ns = p_newest->sent_ns;
+
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < p_sync->count; ++i) {
+        const time_sync_exchange_t * p_ex = &p_sync->exchanges[i];
+        if (p_ex->received_ns - p_ex->sent_ns > fastest * TIME_SYNC_RTT_SLACK) {
+            continue;
+        }
+        double x = ticks_to_ns((int64_t)(p_ex->ticks - p_sync->ref_ticks));
+        double y = (p_ex->sent_ns - p_sync->ref_ns) + (p_ex->received_ns - p_ex->sent_ns) / 2.0;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        ++n;
+    }
+    double det = n * sxx - sx * sx;
+    // Too short a span for a slope: assume the crystal is exact until there is one
+    p_sync->rate = (n > 1 && det > 1e18) ? (n * sxy - sx * sy) / det : 1.0;
+    p_sync->offset_ns = (sy - p_sync->rate * sx) / n;
+
+    p_sync->error_ns = 0;
+    for (size_t i = 0; i < p_sync->count; ++i) {
+        const time_sync_exchange_t * p_ex = &p_sync->exchanges[i];
+        double half_rtt = (p_ex->received_ns - p_ex->sent_ns) / 2.0;
+        if (half_rtt * 2 > fastest * TIME_SYNC_RTT_SLACK) {
+            continue;
+        }
+        double x = ticks_to_ns((int64_t)(p_ex->ticks - p_sync->ref_ticks));
+        double y = (p_ex->sent_ns - p_sync->ref_ns) + half_rtt;
+        double residual = y - (p_sync->offset_ns + p_sync->rate * x);
+        double error = half_rtt + (residual < 0 ? -residual : residual);
+        if (error > p_sync->error_ns) {
+            p_sync->error_ns = error;
+        }
+    }
+    p_sync->valid = true;
+}
+
+void time_sync_restart(time_sync_t * p_sync, uint64_t ticks)
+{
+    time_sync_exchange_t kept[TIME_SYNC_WINDOW];
+    size_t count = 0;
+    size_t first = (p_sync->next + TIME_SYNC_WINDOW - p_sync->count) % TIME_SYNC_WINDOW;
+    for (size_t i = 0; i < p_sync->count; ++i) {
+        const time_sync_exchange_t * p_ex = &p_sync->exchanges[(first + i) % TIME_SYNC_WINDOW];
+        if (p_ex->ticks <= ticks + TIME_SYNC_RESTART_SLACK) {
+            kept[count++] = *p_ex;
+        }
+    }
+    if (count == p_sync->count) {
+        return;
+    }
+    ++p_sync->resets;
+    memcpy(p_sync->exchanges, kept, count * sizeof(kept[0]));
+    p_sync->count = count;
+    p_sync->next = count % TIME_SYNC_WINDOW;
+    fit(p_sync);
+}
+
+void time_sync_add(time_sync_t * p_sync, int64_t sent_ns, int64_t received_ns, uint64_t ticks)
+{
+    if (received_ns < sent_ns) {
+        ++p_sync->rejected;
+        return;
+    }
+    if (p_sync->count > 0 && ticks < newest(p_sync)->ticks) {
+        ++p_sync->resets;
+        p_sync->count = 0;
+        p_sync->next = 0;
+    }
+    p_sync->exchanges[p_sync->next] = (time_sync_exchange_t){
+        .ticks = ticks, .sent_ns = sent_ns, .received_ns = received_ns
+    };
+    p_sync->next = (p_sync->next + 1) % TIME_SYNC_WINDOW;
+    if (p_sync->count < TIME_SYNC_WINDOW) {
+        ++p_sync->count;
+    }
+    ++p_sync->accepted;
+    fit(p_sync);
+}
+
+bool time_sync_to_host(const time_sync_t * p_sync, uint64_t ticks, int64_t * p_host_ns)
+{
+    if (!p_sync->valid) {
+        return false;
+    }
+    double x = ticks_to_ns((int64_t)(ticks - p_sync->ref_ticks));
+    *p_host_ns = p_sync->ref_ns + (int64_t)(p_sync->offset_ns + p_sync->rate * x);
+    return true;
+}
+
+double time_sync_drift_ppm(const time_sync_t * p_sync)
+{
+    return (1.0 / p_sync->rate - 1.0) * 1e6;
+}
+
+int time_sync_request(int64_t now_ns, char * p_buf, size_t size)
+{
+    return snprintf(p_buf, size, "sync %lu %lu\n", (unsigned long)(now_ns / 1000000000),
+                    (unsigned long)(now_ns % 1000000000 / 1000));
+}
@@ -0,0 +1,115 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+/**@file
+ *
+ * @brief    Maps gateway RTC ticks to host time from sync exchanges.
+ *
+ * @details  The host sends "sync <s> <us>" with its clock at sending, and the gateway answers
+ *           "[SYNC] <s> <us> <ticks>" with the ticks read in between. When the answer arrives
+ *           the exchange brackets the tick reading: it was taken no earlier than the send time
+ *           and no later than the receive time. The midpoint is the estimate, half the round
+ *           trip its error.
+ *
+ *           The last TIME_SYNC_WINDOW exchanges are kept. A straight line is fitted through the
+ *           midpoints of those with a round trip within TIME_SYNC_RTT_SLACK of the fastest, so
+ *           the slope gives the drift of the gateway's crystal and exchanges delayed by a busy
+ *           host or UART are left out. The error bound is the widest of the used exchanges'
+ *           half round trip plus its distance from the line; it holds at the exchanges and
+ *           grows with the remaining drift error between and beyond them.
+ *
+ *           Ticks that go backwards mean the gateway was reset: the exchanges are dropped and
+ *           the mapping starts again. Samples can show the reset first, see time_sync_restart.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define TIME_SYNC_WINDOW        64                              /**< Exchanges kept for the fit. */
+#define TIME_SYNC_RTT_SLACK     2                               /**< Round trips up to this many times the fastest are used. */
+#define TIME_SYNC_RESTART_SLACK (10 * 32768)                    /**< Ticks a sample may lag an exchange, see time_sync_restart. */
+
+/**@brief One completed exchange. */
+typedef struct
+{
+    uint64_t            ticks;
+    int64_t             sent_ns;                // Host time the request was sent
+    int64_t             received_ns;            // Host time the answer was read
+} time_sync_exchange_t;
+
+typedef struct
+{
+    time_sync_exchange_t exchanges[TIME_SYNC_WINDOW];
+    size_t              count;
+    size_t              next;
+
+    bool                valid;
+    uint64_t            ref_ticks;              // Fit: host_ns = ref_ns + offset_ns + rate * ns(ticks - ref_ticks)
+    int64_t             ref_ns;
+    double              offset_ns;
+    double              rate;                   // Host ns per gateway ns; 1 + drift
+    double              error_ns;
+
+    uint64_t            accepted;
+    uint64_t            rejected;               // Answers that did not fit their own exchange
+    uint64_t            resets;                 // Gateway restarts
+} time_sync_t;
+
+/**@brief   Reset the estimator. */
+void time_sync_init(time_sync_t * p_sync);
+
+/**@brief   Read an answer line, "[SYNC] <s> <us> <ticks>".
+ *
+ * @param[in]  p_line     Text record, without its newline
+ * @param[in]  len        Length of p_line
+ * @param[out] p_sent_ns  Host send time echoed by the gateway
+ * @param[out] p_ticks    Gateway ticks
+ *
+ * @retval     true if the line is a sync answer.
+ */
+bool time_sync_parse(const uint8_t * p_line, uint16_t len, int64_t * p_sent_ns, uint64_t * p_ticks);
+
+/**@brief   The gateway was reset and its samples have reached ticks.
+ *
+ * @details Exchanges from before the reset are dropped. Those made since have at most about
+ *          ticks, plus TIME_SYNC_RESTART_SLACK for samples still waiting in a frame, and are
+ *          kept. Unless the previous run was shorter than that, no old exchange is kept.
+ */
+void time_sync_restart(time_sync_t * p_sync, uint64_t ticks);
+
+/**@brief   Add an exchange and fit the mapping again. */
+void time_sync_add(time_sync_t * p_sync, int64_t sent_ns, int64_t received_ns, uint64_t ticks);
+
+/**@brief   Gateway ticks to host nanoseconds since the epoch.
+ *
+ * @param[in]  p_sync     Estimator
+ * @param[in]  ticks      Gateway ticks
+ * @param[out] p_host_ns  Host time
+ *
+ * @retval     false if there has been no exchange since the gateway started.
+ */
+bool time_sync_to_host(const time_sync_t * p_sync, uint64_t ticks, int64_t * p_host_ns);
+
+/**@brief   Drift of the gateway clock against the host in parts per million, positive when it runs fast. */
+double time_sync_drift_ppm(const time_sync_t * p_sync);
+
+/**@brief   Format the request that starts an exchange sent at host time now_ns; returns its length. */
+int time_sync_request(int64_t now_ns, char * p_buf, size_t size);
+
+#endif // TIME_SYNC_H
@@ -0,0 +1,97 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "trace.h"
+#include "sensortag_payload.h"
+
+const char * trace_stream_name(stream_id_t stream)
+{
+    const st_payload_def_t * p_def = st_payload_def(stream);
+    return p_def ? p_def->name : NULL;
+}
+
+static int parse_line(char * p_line, trace_sample_t * p_sample)
+{
+    char * p_field = strtok(p_line, ",\n");
+    if (p_field == NULL) {
+        return -1;
+    }
+    p_sample->ticks = strtoull(p_field, NULL, 10);
+
+    p_field = strtok(NULL, ",\n");
+    if (p_field == NULL) {
+        return -1;
+    }
+    p_sample->stream = st_payload_find(p_field);
+    if (p_sample->stream == STREAM_COUNT) {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < stream_value_count(p_sample->stream); ++i) {
+        p_field = strtok(NULL, ",\n");
+        if (p_field == NULL) {
+            return -1;
+        }
+        p_sample->values[i] = (int32_t)strtol(p_field, NULL, 0);
+    }
+    return 0;
+}
+
+int trace_load(const char * p_path, trace_t * p_trace)
+{
+    FILE * p_file = fopen(p_path, "r");
+    if (p_file == NULL) {
+        perror(p_path);
+        return -1;
+    }
+
+    size_t capacity = 1024;
+    p_trace->p_samples = malloc(capacity * sizeof(trace_sample_t));
+    p_trace->count = 0;
+
+    char line[256];
+    unsigned line_no = 0;
+    uint16_t next_seq[STREAM_COUNT] = {0};
+    while (fgets(line, sizeof(line), p_file)) {
+        ++line_no;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (p_trace->count == capacity) {
+            capacity *= 2;
+            p_trace->p_samples = realloc(p_trace->p_samples, capacity * sizeof(trace_sample_t));
+        }
+        if (parse_line(line, &p_trace->p_samples[p_trace->count]) != 0) {
+            fprintf(stderr, "%s:%u: malformed sample\n", p_path, line_no);
+            continue;
+        }
+        p_trace->p_samples[p_trace->count].seq = next_seq[p_trace->p_samples[p_trace->count].stream]++;
+        ++p_trace->count;
+    }
+    fclose(p_file);
+    return 0;
+}
+
+void trace_free(trace_t * p_trace)
+{
+    free(p_trace->p_samples);
+    p_trace->p_samples = NULL;
+    p_trace->count = 0;
+}
@@ -0,0 +1,61 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/**@file
+ *
+ * @brief    Sample traces for the host tools.
+ *
+ * @details  A trace is a text file with one sample per line:
+ *
+ *               ticks,stream,value[,value]
+ *
+ *           where ticks are RTC1 ticks (32768 Hz), stream is "luxo" or "temp" and the values
+ *           are the raw sensor words, as carried by the compressed output stream. Lines
+ *           starting with '#' are comments. A trace holds every notification received, so
+ *           samples are numbered consecutively per stream as they are loaded.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "stream_codec.h"
+
+typedef struct
+{
+    uint64_t            ticks;
+    stream_id_t         stream;
+    uint16_t            seq;
+    int32_t             values[STREAM_MAX_VALUES];
+} trace_sample_t;
+
+typedef struct
+{
+    trace_sample_t      *p_samples;
+    size_t              count;
+} trace_t;
+
+/**@brief   Load a trace file. Returns 0 on success, -1 with a message on stderr otherwise. */
+int trace_load(const char * p_path, trace_t * p_trace);
+
+/**@brief   Release a loaded trace. */
+void trace_free(trace_t * p_trace);
+
+/**@brief   Stream name as used in trace files, or NULL. */
+const char * trace_stream_name(stream_id_t stream);
+
+#endif // TRACE_H
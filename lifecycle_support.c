@@ -45,6 +45,8 @@
  */
 
 #include "lifecycle_support.h"
+#include "error_support.h"
+#include "relay_support.h"
 
 #include "app_timer.h"
 #include "bsp_btn_ble.h"
@@ -53,14 +55,7 @@
 #include "app_error.h"
 
 
-#define CENTRAL_LINK_COUNT      1                               /**< Number of central links used by the application. When changing this number remember to adjust the RAM settings*/
-#define PERIPHERAL_LINK_COUNT   0                               /**< Number of peripheral links used by the application. When changing this number remember to adjust the RAM settings*/
-
-#define UART_TX_BUF_SIZE        256                             /**< UART TX buffer size. */
-#define UART_RX_BUF_SIZE        256                             /**< UART RX buffer size. */
-
-#define APP_TIMER_PRESCALER     0                               /**< Value of the RTC1 PRESCALER register. */
-#define APP_TIMER_OP_QUEUE_SIZE 2                               /**< Size of timer operation queues. */
+#define APP_TIMER_OP_QUEUE_SIZE 4                               /**< Size of timer operation queues. */
 
 #define VS_UUID_COUNT           4
 
@@ -72,31 +67,6 @@ void timer_init(void)
 }
 
 
-void uart_init(app_uart_event_handler_t uart_event_handler)
-{
-    uint32_t err_code;
-
-    const app_uart_comm_params_t comm_params =
-      {
-        .rx_pin_no    = RX_PIN_NUMBER,
-        .tx_pin_no    = TX_PIN_NUMBER,
-        .rts_pin_no   = RTS_PIN_NUMBER,
-        .cts_pin_no   = CTS_PIN_NUMBER,
-        .flow_control = APP_UART_FLOW_CONTROL_ENABLED,
-        .use_parity   = false,
-        .baud_rate    = UART_BAUDRATE_BAUDRATE_Baud115200
-      };
-
-    APP_UART_FIFO_INIT(&comm_params,
-                        UART_RX_BUF_SIZE,
-                        UART_TX_BUF_SIZE,
-                        uart_event_handler,
-                        APP_IRQ_PRIORITY_MID,
-                        err_code);
-
-    APP_ERROR_CHECK(err_code);
-}
-
 
 void buttons_leds_init(bsp_event_callback_t bsp_event_handler)
 {
@@ -134,6 +104,9 @@ void ble_stack_init(ble_evt_handler_t ble_event_handler)
     APP_ERROR_CHECK(err_code);
    
     ble_enable_params.common_enable_params.vs_uuid_count = VS_UUID_COUNT;
+#if (NRF_SD_BLE_API_VERSION == 3)
+    ble_enable_params.gatt_enable_params.att_mtu = RELAY_MAX_ATT_MTU;
+#endif
 
     //Check the ram settings against the used number of links
     CHECK_RAM_START_ADDR(CENTRAL_LINK_COUNT,PERIPHERAL_LINK_COUNT);
@@ -148,12 +121,14 @@ void ble_stack_init(ble_evt_handler_t ble_event_handler)
 }
 
 void st_c_init(st_client_t* sensor_tag_client, 
-               st_client_evt_handler_t sensor_tag_event_handler)
+               st_client_evt_handler_t sensor_tag_event_handler,
+               st_client_timestamp_source_t timestamp_source)
 {
     uint32_t        err_code;
     st_client_init_t st_c_init_params;
 
     st_c_init_params.evt_handler = sensor_tag_event_handler;
+    st_c_init_params.timestamp_source = timestamp_source;
     err_code = st_client_init(sensor_tag_client, &st_c_init_params);
     APP_ERROR_CHECK(err_code);
 }
@@ -161,7 +136,7 @@ void st_c_init(st_client_t* sensor_tag_client,
 void sleep_mode_enter(void)
 {
     uint32_t err_code = bsp_indication_set(BSP_INDICATE_IDLE);
-    APP_ERROR_CHECK(err_code);
+    ERROR_CHECK(ERROR_SITE_INDICATION, err_code, NULL);
 
     // Prepare wakeup buttons.
     err_code = bsp_btn_ble_sleep_mode_prepare();
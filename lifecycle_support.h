@@ -47,25 +47,22 @@
 #ifndef LIFECYCLE_SUPPORT_H
 #define LIFECYCLE_SUPPORT_H
 
-#include "app_uart.h"
 #include "bsp.h"
 #include "ble_db_discovery.h"
 #include "ble_stack_handler_types.h"
 #include "ble_sensortag_client.h"
 
+#define APP_TIMER_PRESCALER     0                               /**< Value of the RTC1 PRESCALER register. */
+
+#define CENTRAL_LINK_COUNT      1                               /**< Number of central links used by the application. When changing this number remember to adjust the RAM settings*/
+#define PERIPHERAL_LINK_COUNT   1                               /**< Number of peripheral links used by the application. When changing this number remember to adjust the RAM settings*/
+#define LINK_COUNT              (CENTRAL_LINK_COUNT + PERIPHERAL_LINK_COUNT)
 
 /**@brief Function for initializing the application timer
  */
 void timer_init(void);
 
 
-/**@brief Function for initializing the UART.
- *
- * @param[in] uart_event_handler        event loop function to handle UART events 
- */
-void uart_init(app_uart_event_handler_t uart_event_handler);
-
-
 /**@brief Function for initializing buttons and leds.
  *
  * @param[in] bsp_event_handler        event loop function to handle 'hardware' events 
@@ -92,9 +89,11 @@ void ble_stack_init(ble_evt_handler_t ble_event_handler);
  * 
  * @param[in] sensor_tag_client         client structure to be initialized
  * @param[in] sensor_tag_event_handler  event loop function to handle CLIENT events 
+ * @param[in] timestamp_source          clock used to stamp received data 
  */
 void st_c_init(st_client_t* sensor_tag_client, 
-               st_client_evt_handler_t sensor_tag_event_handler);
+               st_client_evt_handler_t sensor_tag_event_handler,
+               st_client_timestamp_source_t timestamp_source);
 
 
 /**@brief Function for asserts in the SoftDevice.
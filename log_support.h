@@ -0,0 +1,72 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef LOG_SUPPORT_H
+#define LOG_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Tokenized diagnostic messages.
+ *
+ * @details  LOG("format", args...) takes printf style integer arguments. The format string is
+ *           placed in the .log_strings section, which the linker script keeps together in
+ *           flash; its offset in the section is its token. In text mode output_log prints the
+ *           message on the gateway, so a serial terminal reads it as before. In compressed mode
+ *           only the token and the arguments, as 32 bit words, reach the host (see
+ *           output_support.h). `make log_strings` extracts the section as the dictionary for
+ *           `st_ingestd -d`, which prints the message again.
+ *
+ *           Formats take no newline and only integer conversions (d, i, u, x, X, c); each
+ *           argument is passed as an int32_t, at most STREAM_LOG_MAX_ARGS of them. The arguments
+ *           are still checked against the format as printf's would be. Messages with strings
+ *           still use printf.
+ *
+ *           Build with `make LOG_TOKENIZED=0` to send the messages as printf lines instead;
+ *           the dictionary must come from the same build as the firmware.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "output_support.h"
+#include "stream_codec.h"
+
+#ifndef LOG_TOKENIZED
+#define LOG_TOKENIZED           1
+#endif
+
+#if LOG_TOKENIZED
+
+#define LOG_ARGS(...)           ((const int32_t[]){ 0 __VA_OPT__(,) __VA_ARGS__ })
+#define LOG_ARG_COUNT(...)      (sizeof(LOG_ARGS(__VA_ARGS__)) / sizeof(int32_t) - 1)
+
+#define LOG(p_format, ...)                                                                      \
+    do {                                                                                        \
+        static const char log_format[] __attribute__((section(".log_strings"), used)) = p_format; \
+        static_assert(LOG_ARG_COUNT(__VA_ARGS__) <= STREAM_LOG_MAX_ARGS, "too many LOG arguments"); \
+        if (0) {                                                                                \
+            printf(p_format __VA_OPT__(,) __VA_ARGS__);     /* only checks the format */        \
+        }                                                                                       \
+        output_log(log_format, &LOG_ARGS(__VA_ARGS__)[1], LOG_ARG_COUNT(__VA_ARGS__));          \
+    } while (0)
+
+#else
+
+#define LOG(p_format, ...)      printf(p_format "\n" __VA_OPT__(,) __VA_ARGS__)
+
+#endif // LOG_TOKENIZED
+
+#endif // LOG_SUPPORT_H
@@ -0,0 +1,77 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "mem_support.h"
+
+#include "nrf.h"
+
+// Defined by nrf5x_common.ld and the linker scripts
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+extern uint32_t __start_noinit;
+extern uint32_t __stop_noinit;
+extern uint32_t __HeapBase;
+extern uint32_t __HeapLimit;
+extern uint32_t __StackLimit;
+extern uint32_t __StackTop;
+
+#define SYMBOL_DISTANCE(from, to)  ((uint32_t)((uintptr_t)&(to) - (uintptr_t)&(from)))
+
+
+void mem_support_init(void)
+{
+    uint32_t * p_word = &__StackLimit;
+    uint32_t * p_end = (uint32_t *)(__get_MSP() - MEM_PAINT_MARGIN);
+
+    while (p_word < p_end) {
+        *p_word++ = MEM_STACK_PAINT;
+    }
+}
+
+void mem_support_usage(mem_usage_t * p_usage)
+{
+    const uint32_t * p_word = &__StackLimit;
+    const uint32_t * p_top = &__StackTop;
+
+    while (p_word < p_top && *p_word == MEM_STACK_PAINT) {
+        ++p_word;
+    }
+
+    p_usage->data       = SYMBOL_DISTANCE(__data_start__, __data_end__);
+    p_usage->bss        = SYMBOL_DISTANCE(__bss_start__, __bss_end__);
+    p_usage->noinit     = SYMBOL_DISTANCE(__start_noinit, __stop_noinit);
+    p_usage->heap       = SYMBOL_DISTANCE(__HeapBase, __HeapLimit);
+    p_usage->unused     = SYMBOL_DISTANCE(__HeapLimit, __StackLimit);
+    p_usage->stack_size = SYMBOL_DISTANCE(__StackLimit, __StackTop);
+    p_usage->stack_peak = (uint32_t)((uintptr_t)p_top - (uintptr_t)p_word);
+}
+
+void mem_support_report(void)
+{
+    mem_usage_t usage;
+    mem_support_usage(&usage);
+
+    printf("[MEM] data=%lu bss=%lu noinit=%lu heap=%lu unused=%lu\n",
+           (unsigned long)usage.data, (unsigned long)usage.bss, (unsigned long)usage.noinit,
+           (unsigned long)usage.heap, (unsigned long)usage.unused);
+    printf("[MEM] stack=%lu peak=%lu free=%lu\n",
+           (unsigned long)usage.stack_size, (unsigned long)usage.stack_peak,
+           (unsigned long)(usage.stack_size - usage.stack_peak));
+}
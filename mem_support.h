@@ -0,0 +1,60 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef MEM_SUPPORT_H
+#define MEM_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Stack high-water mark and RAM layout.
+ *
+ * @details  mem_support_init fills the unused stack, from __StackLimit up to just below the
+ *           caller's frame, with MEM_STACK_PAINT. The stack grows down, so the lowest word that
+ *           no longer holds the pattern marks the deepest the stack has reached since boot.
+ *           The SoftDevice runs its handlers on the same stack, so its use is included.
+ *
+ *           The layout comes from the symbols nrf5x_common.ld defines: .data, .bss, .noinit,
+ *           the heap (empty, __HEAP_SIZE=0), and the gap between the heap and the stack, which
+ *           is RAM that nothing uses. `make memory` lists the largest symbols behind these.
+ */
+
+#include <stdint.h>
+
+#define MEM_STACK_PAINT         0xA5A5A5A5                      /**< Pattern in stack that has never been used. */
+#define MEM_PAINT_MARGIN        64                              /**< Bytes below the caller's SP left alone. */
+
+/**@brief RAM use in bytes. */
+typedef struct
+{
+    uint32_t            data;
+    uint32_t            bss;
+    uint32_t            noinit;
+    uint32_t            heap;
+    uint32_t            unused;                                 // Between the heap and the stack
+    uint32_t            stack_size;
+    uint32_t            stack_peak;                             // Deepest use since boot
+} mem_usage_t;
+
+
+/**@brief   Paint the stack. Call first thing after reset, before the stack gets deep. */
+void mem_support_init(void);
+
+/**@brief   Measure the current RAM use and stack high-water mark. */
+void mem_support_usage(mem_usage_t * p_usage);
+
+/**@brief   Print mem_support_usage as [MEM] lines. */
+void mem_support_report(void);
+
+#endif // MEM_SUPPORT_H
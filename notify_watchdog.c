@@ -0,0 +1,60 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "notify_watchdog.h"
+
+void notify_watchdog_start(notify_watchdog_t * p_watchdog, uint32_t period, uint64_t now)
+{
+    p_watchdog->period = period;
+    p_watchdog->last = now;
+    p_watchdog->reenables = 0;
+}
+
+void notify_watchdog_stop(notify_watchdog_t * p_watchdog)
+{
+    p_watchdog->period = 0;
+}
+
+bool notify_watchdog_active(const notify_watchdog_t * p_watchdog)
+{
+    return p_watchdog->period != 0;
+}
+
+void notify_watchdog_feed(notify_watchdog_t * p_watchdog, uint64_t now)
+{
+    p_watchdog->last = now;
+    p_watchdog->reenables = 0;
+}
+
+notify_watchdog_action_t notify_watchdog_check(notify_watchdog_t * p_watchdog, uint64_t now)
+{
+    if (p_watchdog->period == 0 || now <= p_watchdog->last) {
+        return NOTIFY_WATCHDOG_OK;
+    }
+
+    uint64_t missed = (now - p_watchdog->last) / p_watchdog->period;
+    if (missed >= NOTIFY_WATCHDOG_DISCONNECT_PERIODS) {
+        notify_watchdog_stop(p_watchdog);
+        return NOTIFY_WATCHDOG_DISCONNECT;
+    }
+    if (missed >= (uint64_t)NOTIFY_WATCHDOG_REENABLE_PERIODS * (p_watchdog->reenables + 1)) {
+        ++p_watchdog->reenables;
+        return NOTIFY_WATCHDOG_REENABLE;
+    }
+    return NOTIFY_WATCHDOG_OK;
+}
@@ -0,0 +1,73 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef NOTIFY_WATCHDOG_H
+#define NOTIFY_WATCHDOG_H
+
+/**@file
+ *
+ * @brief    Detects a service that has stopped notifying while its link stays up.
+ *
+ * @details  Each watched service expects a notification every period. A check counts the whole
+ *           periods since the last one: after NOTIFY_WATCHDOG_REENABLE_PERIODS it asks for the
+ *           service to be enabled again (the tag may have reset the sensor and lost its
+ *           configuration), once more after twice as many, and after
+ *           NOTIFY_WATCHDOG_DISCONNECT_PERIODS it gives up on the link.
+ *
+ *           The caller drives checks from a timer; their interval only sets how late an action
+ *           may come, not when it is due.
+ *
+ * @note     This module has no SDK dependencies.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NOTIFY_WATCHDOG_REENABLE_PERIODS   3                    /**< Missed periods before the service is enabled again. */
+#define NOTIFY_WATCHDOG_DISCONNECT_PERIODS 8                    /**< Missed periods before the link is dropped. */
+
+/**@brief Action the caller should take after a check. */
+typedef enum
+{
+    NOTIFY_WATCHDOG_OK,
+    NOTIFY_WATCHDOG_REENABLE,
+    NOTIFY_WATCHDOG_DISCONNECT,
+} notify_watchdog_action_t;
+
+/**@brief Watchdog of one service. Timestamps in the caller's ticks. */
+typedef struct
+{
+    uint32_t            period;                                 // Expected notification interval, 0 when not watched
+    uint64_t            last;                                   // Last notification, or when watching started
+    uint8_t             reenables;                              // Re-enables asked for since the last notification
+} notify_watchdog_t;
+
+
+/**@brief   Start watching, or restart with a new period, as if a notification had just arrived. */
+void notify_watchdog_start(notify_watchdog_t * p_watchdog, uint32_t period, uint64_t now);
+
+/**@brief   Stop watching. */
+void notify_watchdog_stop(notify_watchdog_t * p_watchdog);
+
+/**@brief   True while the service is watched. */
+bool notify_watchdog_active(const notify_watchdog_t * p_watchdog);
+
+/**@brief   A notification arrived. */
+void notify_watchdog_feed(notify_watchdog_t * p_watchdog, uint64_t now);
+
+/**@brief   Check for missed notifications. A disconnect also stops the watchdog. */
+notify_watchdog_action_t notify_watchdog_check(notify_watchdog_t * p_watchdog, uint64_t now);
+
+#endif // NOTIFY_WATCHDOG_H
@@ -0,0 +1,361 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "output_support.h"
+#include "fmt_support.h"
+#include "lifecycle_support.h"
+#include "relay_support.h"
+#include "stream_codec.h"
+#include "time_support.h"
+#include "uart_support.h"
+
+#include "app_timer.h"
+#include "app_error.h"
+
+// Defined by the linker scripts: the LOG format strings, whose offsets in it are their tokens
+extern const char __start_log_strings[];
+
+#define OUTPUT_FLUSH_INTERVAL_MS    5000                        /**< Longest time a compressed sample waits for its frame. */
+
+#define OUTPUT_LINE_MAX             80                          /**< Longest text line, longer lines are truncated. */
+#define OUTPUT_TEMP_FRAC_BITS       7                           /**< Temperature words are in 1/128 C. */
+#define OUTPUT_ROW_MAX              120                         /**< Longest table row; fits an empty urgent lane. */
+#define OUTPUT_TABLE_RETRY_MS       10                          /**< Wait for the lane to drain before the next rows. */
+
+// All callers (BLE events, app_timer, UART events) run at APP_IRQ_PRIORITY_LOWEST on both
+// platforms (see uart_init), so none preempts another and the encoder state needs no further
+// protection.
+
+APP_TIMER_DEF(m_flush_timer);
+APP_TIMER_DEF(m_table_timer);
+
+/**@brief A table written as its lane drains, see output_table. */
+typedef struct
+{
+    output_row_t        row;                                    // Builds a text row; NULL for counter frames
+    uart_lane_t         lane;
+    uint8_t             next;                                   // Row to write next
+    uint8_t             count;
+} output_table_t;
+
+static output_format_t  m_format = OUTPUT_FORMAT_DEFAULT;
+static stream_encoder_t m_encoder;
+static output_table_t   m_table;
+static const char * const * m_stats_names;                      // Counters of the table in progress
+static const uint32_t * m_stats_values;
+
+
+static void output_write(uart_lane_t lane, const uint8_t * p_data, uint16_t len)
+{
+    // Bytes that do not fit are dropped and counted; the decoder recovers at the next delimiter
+    UNUSED_VARIABLE(uart_write(lane, p_data, len));
+    relay_write(p_data, len);
+}
+
+/**@brief   Route stdout and stderr to the output sinks; replaces the SDK's retarget.c.
+ *
+ * @details Diagnostics report link events, faults and command replies, so they take the
+ *          urgent lane.
+ */
+int _write(int file, const char * p_char, int len)
+{
+    UNUSED_PARAMETER(file);
+    // Report everything as written, so that newlib does not retry bytes that were dropped
+    output_write(UART_LANE_URGENT, (const uint8_t *)p_char, (uint16_t)len);
+    return len;
+}
+
+/**@brief Write a text line built with fmt_support in one piece, so that lost bytes are counted as
+ *        for frames. A line cut short still ends with its newline.
+ */
+static void output_line_end(fmt_t * p_line)
+{
+    if (p_line->len == p_line->size) {
+        p_line->len--;
+    }
+    fmt_char(p_line, '\n');
+}
+
+static void output_line(uart_lane_t lane, fmt_t * p_line)
+{
+    output_line_end(p_line);
+    output_write(lane, (const uint8_t *)p_line->p_buf, p_line->len);
+}
+
+/**@brief   Write rows of the table in progress while its lane has room for them.
+ *
+ * @details A row that does not fit waits for the table timer rather than being dropped. All
+ *          writers run at the UART's own interrupt priority, so the lane cannot drain while
+ *          one handler writes a whole table.
+ */
+static void output_table_pump(void)
+{
+    while (m_table.next < m_table.count) {
+        uint8_t row[MAX(OUTPUT_ROW_MAX, STREAM_FRAME_MAX_ENCODED)];
+        uint16_t len;
+        uint8_t rows = 1;
+
+        if (m_table.row != NULL) {
+            fmt_t line;
+            fmt_init(&line, (char *)row, OUTPUT_ROW_MAX);
+            m_table.row(m_table.next, &line);
+            output_line_end(&line);
+            len = line.len;
+        }
+        else {
+            // Numbered when written, so that frame_seq follows the order on the wire
+            len = stream_stats_encode(m_table.next, &m_stats_values[m_table.next],
+                                      m_table.count - m_table.next, m_encoder.frame_seq, row, &rows);
+        }
+        if (uart_free(m_table.lane) < len) {
+            uint32_t err_code = app_timer_start(m_table_timer,
+                                                APP_TIMER_TICKS(OUTPUT_TABLE_RETRY_MS, APP_TIMER_PRESCALER),
+                                                NULL);
+            if (err_code != NRF_SUCCESS) {
+                // No timer to resume from: give the rest up rather than stall every later table
+                m_table.next = m_table.count;
+            }
+            return;
+        }
+        if (m_table.row == NULL) {
+            m_encoder.frame_seq++;
+        }
+        output_write(m_table.lane, row, len);
+        m_table.next += rows;
+    }
+}
+
+static void table_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    output_table_pump();
+}
+
+bool output_table(uart_lane_t lane, output_row_t row, uint8_t count)
+{
+    if (m_table.next < m_table.count) {
+        return false;
+    }
+    m_table = (output_table_t){ .row = row, .lane = lane, .next = 0, .count = count };
+    output_table_pump();
+    return true;
+}
+
+
+void output_flush(void)
+{
+    uint8_t frame[STREAM_FRAME_MAX_ENCODED];
+    uint16_t len = stream_encoder_finish(&m_encoder, frame);
+    output_write(UART_LANE_BULK, frame, len);
+}
+
+static void flush_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    output_flush();
+}
+
+static stream_id_t stream_from_evt(st_client_evt_type_t evt_type)
+{
+    switch (evt_type)
+    {
+        case ST_CLIENT_EVT_LUXO_DATA:
+            return STREAM_LUXO;
+        case ST_CLIENT_EVT_TEMP_DATA:
+            return STREAM_TEMP;
+        default:
+            return STREAM_COUNT;
+    }
+}
+
+/**@brief Print a timestamp as seconds.milliseconds, and a sequence number. */
+static void output_text_prefix(fmt_t * p_line, uint64_t ticks, uint16_t seq)
+{
+    uint64_t ms = ticks * 1000 / TIME_TICKS_PER_SECOND;
+    fmt_char(p_line, '[');
+    fmt_uint(p_line, (uint32_t)(ms / 1000), 0);
+    fmt_char(p_line, '.');
+    fmt_uint(p_line, (uint32_t)(ms % 1000), 3);
+    fmt_str(p_line, "] #");
+    fmt_uint(p_line, seq, 0);
+    fmt_char(p_line, ' ');
+}
+
+/**@brief Write a sample as text, from the raw words: the temperatures are 1/128 C fixed point,
+ *        printed with two decimals as "%3.2f" did.
+ */
+static void output_text(st_client_evt_type_t evt_type, const st_client_data_t * p_data)
+{
+    // One write per line, so that the urgent lane never cuts into it
+    char buf[OUTPUT_LINE_MAX];
+    fmt_t line;
+
+    fmt_init(&line, buf, sizeof(buf));
+    output_text_prefix(&line, p_data->timestamp, p_data->seq);
+    switch (evt_type)
+    {
+        case ST_CLIENT_EVT_LUXO_DATA:
+            fmt_str(&line, "Lux value: ");
+            fmt_int(&line, p_data->luxo_data);
+            break;
+        case ST_CLIENT_EVT_TEMP_DATA:
+            fmt_str(&line, "IR Temp: ");
+            fmt_fixed(&line, p_data->raw[0], OUTPUT_TEMP_FRAC_BITS, 2);
+            fmt_str(&line, "\t Ambient Temp: ");
+            fmt_fixed(&line, p_data->raw[1], OUTPUT_TEMP_FRAC_BITS, 2);
+            break;
+        default:
+            return;
+    }
+    output_line(UART_LANE_BULK, &line);
+}
+
+static void output_compressed(st_client_evt_type_t evt_type, const st_client_data_t * p_data)
+{
+    stream_id_t stream = stream_from_evt(evt_type);
+    if (stream == STREAM_COUNT || p_data->raw_count != stream_value_count(stream)) {
+        return;
+    }
+    if (!stream_encoder_put(&m_encoder, stream, p_data->timestamp, p_data->seq, p_data->raw)) {
+        output_flush();
+        UNUSED_VARIABLE(stream_encoder_put(&m_encoder, stream, p_data->timestamp, p_data->seq, p_data->raw));
+    }
+    if (stream_encoder_full(&m_encoder)) {
+        output_flush();
+    }
+}
+
+void output_sample(st_client_evt_type_t evt_type, const st_client_data_t * p_data)
+{
+    if (!p_data->valid) {
+        return;
+    }
+    if (m_format == OUTPUT_FORMAT_COMPRESSED) {
+        output_compressed(evt_type, p_data);
+    }
+    else {
+        output_text(evt_type, p_data);
+    }
+}
+
+void output_alert(const rule_alert_t * p_alert)
+{
+    if (m_format == OUTPUT_FORMAT_COMPRESSED) {
+        const stream_alert_t alert = {
+            .rule_index  = p_alert->rule_index,
+            .stream      = p_alert->p_rule->stream,
+            .value_index = p_alert->p_rule->value_index,
+            .kind        = p_alert->p_rule->kind,
+            .raised      = p_alert->raised,
+            .value       = p_alert->value
+        };
+        uint8_t frame[STREAM_FRAME_MAX_ENCODED];
+        output_flush();
+        output_write(UART_LANE_URGENT, frame, stream_alert_encode(&alert, m_encoder.urgent_seq++, frame));
+    }
+    else {
+        char buf[OUTPUT_LINE_MAX];
+        fmt_t line;
+
+        fmt_init(&line, buf, sizeof(buf));
+        fmt_str(&line, p_alert->raised ? "ALERT raised: rule " : "ALERT cleared: rule ");
+        fmt_uint(&line, p_alert->rule_index, 0);
+        fmt_str(&line, " on stream ");
+        fmt_uint(&line, p_alert->p_rule->stream, 0);
+        fmt_str(&line, " value ");
+        fmt_uint(&line, p_alert->p_rule->value_index, 0);
+        fmt_str(&line, ": ");
+        fmt_int(&line, p_alert->value);
+        output_line(UART_LANE_URGENT, &line);
+    }
+}
+
+void output_log(const char * p_format, const int32_t * p_args, uint8_t count)
+{
+    if (m_format == OUTPUT_FORMAT_COMPRESSED) {
+        stream_log_t log = {
+            .token = (uint32_t)(p_format - __start_log_strings),
+            .count = MIN(count, STREAM_LOG_MAX_ARGS)
+        };
+        memcpy(log.args, p_args, log.count * sizeof(int32_t));
+
+        // Unlike alerts, the sample frame is left to fill: a diagnostic does not refer to it
+        uint8_t frame[STREAM_FRAME_MAX_ENCODED];
+        output_write(UART_LANE_URGENT, frame, stream_log_encode(&log, m_encoder.urgent_seq++, frame));
+    }
+    else {
+        char buf[OUTPUT_LINE_MAX];
+        fmt_t line;
+
+        fmt_init(&line, buf, sizeof(buf));
+        fmt_format(&line, p_format, p_args, count);
+        output_line(UART_LANE_URGENT, &line);
+    }
+}
+
+static void output_stats_row(uint8_t index, fmt_t * p_line)
+{
+    fmt_str(p_line, "[STATS] ");
+    fmt_str(p_line, m_stats_names[index]);
+    fmt_char(p_line, '=');
+    fmt_uint(p_line, m_stats_values[index], 0);
+}
+
+bool output_stats(const char * const * p_names, const uint32_t * p_values, uint8_t count)
+{
+    if (m_table.next < m_table.count) {
+        return false;
+    }
+    m_stats_names = p_names;
+    m_stats_values = p_values;
+    if (m_format == OUTPUT_FORMAT_COMPRESSED) {
+        output_flush();
+        return output_table(UART_LANE_BULK, NULL, count);
+    }
+    return output_table(UART_LANE_BULK, output_stats_row, count);
+}
+
+void output_format_set(output_format_t format)
+{
+    output_flush();
+    m_format = format;
+}
+
+output_format_t output_format_get(void)
+{
+    return m_format;
+}
+
+void output_init(output_format_t format)
+{
+    uint32_t err_code;
+
+    stream_encoder_init(&m_encoder);
+    m_format = format;
+
+    err_code = app_timer_create(&m_flush_timer, APP_TIMER_MODE_REPEATED, flush_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_create(&m_table_timer, APP_TIMER_MODE_SINGLE_SHOT, table_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_start(m_flush_timer,
+                               APP_TIMER_TICKS(OUTPUT_FLUSH_INTERVAL_MS, APP_TIMER_PRESCALER),
+                               NULL);
+    APP_ERROR_CHECK(err_code);
+}
@@ -0,0 +1,128 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef OUTPUT_SUPPORT_H
+#define OUTPUT_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Sensor stream output.
+ *
+ * @details  Decoded samples from the SensorTag client are written to the UART, and to a
+ *           connected relay client (see relay_support.h), either as human readable text lines,
+ *           or as compressed binary frames (see stream_codec.h).
+ *           Command replies and the remaining printf diagnostics go to the same outputs; a binary
+ *           decoder skips them because they never contain the frame delimiter and never pass the
+ *           frame CRC. Diagnostics written with LOG (see log_support.h) are
+ *           tokenized in compressed mode.
+ *
+ *           On the UART, alerts and diagnostics take the urgent lane and samples and counter
+ *           tables the bulk lane (see uart_support.h), so an alert may overtake samples queued
+ *           before it.
+ */
+
+#include <stdint.h>
+
+#include "ble_sensortag_client.h"
+#include "fmt_support.h"
+#include "rule_engine.h"
+#include "uart_support.h"
+
+/**@brief Output encodings for the sensor stream. */
+typedef enum
+{
+    OUTPUT_FORMAT_TEXT,                     // One printf line per sample
+    OUTPUT_FORMAT_COMPRESSED,               // Delta / run-length frames from stream_codec
+} output_format_t;
+
+#ifndef OUTPUT_FORMAT_DEFAULT
+#define OUTPUT_FORMAT_DEFAULT   OUTPUT_FORMAT_TEXT
+#endif
+
+/**@brief   Builds row index of a table written by output_table; the newline is added. */
+typedef void (* output_row_t)(uint8_t index, fmt_t * p_line);
+
+
+/**@brief   Initialize the output module and start its periodic flush timer.
+ *
+ * @param[in] format    Initial output format
+ */
+void output_init(output_format_t format);
+
+/**@brief   Change the output format. Any partly built frame is flushed first. */
+void output_format_set(output_format_t format);
+
+/**@brief   The output format currently in use. */
+output_format_t output_format_get(void);
+
+/**@brief   Write one decoded sample to the output stream.
+ *
+ * @param[in] evt_type  The client data event the sample came from
+ * @param[in] p_data    The decoded sample; ignored unless valid
+ */
+void output_sample(st_client_evt_type_t evt_type, const st_client_data_t * p_data);
+
+/**@brief   Write an alert from the rule engine immediately.
+ *
+ * @details In compressed mode the partly built sample frame is flushed first, so that the
+ *          samples that led to the alert follow close behind it on the bulk lane. Alert frames
+ *          are numbered in their own frame_seq sequence.
+ */
+void output_alert(const rule_alert_t * p_alert);
+
+/**@brief   Write a diagnostic immediately; called through LOG (see log_support.h).
+ *
+ * @details Text mode prints the message (fmt_format). Compressed mode sends a STREAM_FRAME_LOG
+ *          frame, numbered in the alert sequence, with the format's token in place of the
+ *          text; the host needs the firmware's log dictionary to print it.
+ *
+ * @param[in] p_format  Format string, in the .log_strings section
+ * @param[in] p_args    Arguments, as 32 bit words
+ * @param[in] count     Number of arguments; at most STREAM_LOG_MAX_ARGS are sent
+ */
+void output_log(const char * p_format, const int32_t * p_args, uint8_t count);
+
+/**@brief   Write a table of text lines, as fast as the lane drains.
+ *
+ * @details As many rows as the lane has room for are written straight away, the rest from a
+ *          timer as it drains, so a long table never overruns the lane and nothing is dropped.
+ *          Only one table, or counter table, is written at a time.
+ *
+ * @param[in] lane      Lane to write to
+ * @param[in] row       Builds each row, called when the row is written
+ * @param[in] count     Number of rows
+ *
+ * @retval  false if another table is still being written.
+ */
+bool output_table(uart_lane_t lane, output_row_t row, uint8_t count);
+
+/**@brief   Write a table of runtime counters on the bulk lane, paced as output_table.
+ *
+ * @details Text mode writes one "[STATS] name=value" line per counter. Compressed mode flushes
+ *          the sample frame, then sends as many STREAM_FRAME_STATS frames as the table needs.
+ *          Values are read as each row is written.
+ *
+ * @param[in] p_names   Counter names, used in text mode; must stay valid until written
+ * @param[in] p_values  Counter values; must stay valid until written
+ * @param[in] count     Number of counters
+ *
+ * @retval  false if another table is still being written.
+ */
+bool output_stats(const char * const * p_names, const uint32_t * p_values, uint8_t count);
+
+/**@brief   Send any partly built frame immediately. */
+void output_flush(void);
+
+#endif // OUTPUT_SUPPORT_H
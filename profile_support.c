@@ -0,0 +1,137 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "profile_support.h"
+#include "fmt_support.h"
+#include "output_support.h"
+
+#if PROFILE_ENABLED
+
+#define PROFILE_NAME_WIDTH      9                               /**< Stage names are padded to line up. */
+
+#if PROFILE_TIMER_BITS == 16
+#define PROFILE_TIMER_BITMODE   TIMER_BITMODE_BITMODE_16Bit
+#define PROFILE_TIMER_MASK      0xFFFF
+#else
+#define PROFILE_TIMER_BITMODE   TIMER_BITMODE_BITMODE_32Bit
+#define PROFILE_TIMER_MASK      0xFFFFFFFF
+#endif
+
+typedef struct
+{
+    uint32_t            buckets[PROFILE_BUCKETS];
+    uint32_t            count;
+    uint32_t            max;
+} profile_histogram_t;
+
+static const char * m_stage_names[PROFILE_STAGE_COUNT] = {
+    [PROFILE_BLE_EVT_DISPATCH] = "dispatch",
+    [PROFILE_ST_CLIENT]        = "st_client",
+    [PROFILE_DECODE]           = "decode",
+    [PROFILE_RULES]            = "rules",
+    [PROFILE_OUTPUT]           = "output",
+};
+
+static profile_histogram_t m_histograms[PROFILE_STAGE_COUNT];
+
+
+void profile_record(profile_stage_t stage, uint32_t start)
+{
+    uint32_t ticks = (profile_now() - start) & PROFILE_TIMER_MASK;
+    uint8_t bucket = ticks ? 32 - __builtin_clz(ticks) : 0;
+    profile_histogram_t * p_hist = &m_histograms[stage];
+
+    ++p_hist->buckets[bucket];
+    ++p_hist->count;
+    if (ticks > p_hist->max) {
+        p_hist->max = ticks;
+    }
+}
+
+void profile_init(void)
+{
+    NRF_TIMER1->TASKS_STOP  = 1;
+    NRF_TIMER1->MODE        = TIMER_MODE_MODE_Timer;
+    NRF_TIMER1->BITMODE     = PROFILE_TIMER_BITMODE;
+    NRF_TIMER1->PRESCALER   = PROFILE_TIMER_PRESCALER;
+    NRF_TIMER1->TASKS_CLEAR = 1;
+    NRF_TIMER1->TASKS_START = 1;
+    profile_reset();
+}
+
+void profile_reset(void)
+{
+    memset(m_histograms, 0, sizeof(m_histograms));
+}
+
+/**@brief Row 0 is the header, then one row per stage. */
+static void profile_row(uint8_t index, fmt_t * p_line)
+{
+    fmt_str(p_line, "[PROF] ");
+    if (index == 0) {
+        fmt_str(p_line, "ticks per stage, ");
+        fmt_uint(p_line, PROFILE_TICKS_PER_US, 0);
+        fmt_str(p_line, " per us, buckets are <2^n");
+        return;
+    }
+
+    const profile_histogram_t * p_hist = &m_histograms[index - 1];
+    const char * p_name = m_stage_names[index - 1];
+    fmt_str(p_line, p_name);
+    for (size_t len = strlen(p_name); len < PROFILE_NAME_WIDTH; ++len) {
+        fmt_char(p_line, ' ');
+    }
+    fmt_str(p_line, " n=");
+    fmt_uint(p_line, p_hist->count, 0);
+    fmt_str(p_line, " max=");
+    fmt_uint(p_line, p_hist->max, 0);
+    fmt_char(p_line, ':');
+    for (uint8_t bucket = 0; bucket < PROFILE_BUCKETS; ++bucket) {
+        if (p_hist->buckets[bucket]) {
+            fmt_char(p_line, ' ');
+            fmt_uint(p_line, bucket, 0);
+            fmt_char(p_line, ':');
+            fmt_uint(p_line, p_hist->buckets[bucket], 0);
+        }
+    }
+}
+
+bool profile_dump(void)
+{
+    // Built one whole line at a time and paced, so the urgent lane never drops part of one
+    return output_table(UART_LANE_URGENT, profile_row, 1 + PROFILE_STAGE_COUNT);
+}
+
+#else
+
+void profile_init(void)
+{
+}
+
+void profile_reset(void)
+{
+}
+
+bool profile_dump(void)
+{
+    printf("[PROF] profiling not enabled, build with PROFILE=1\n");
+    return true;
+}
+
+#endif // PROFILE_ENABLED
@@ -0,0 +1,106 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef PROFILE_SUPPORT_H
+#define PROFILE_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Hot path latency histograms.
+ *
+ * @details  The Cortex-M0 has no DWT cycle counter, so TIMER1 is left free-running instead.
+ *           PROFILE_BEGIN captures the timer, PROFILE_END adds the elapsed ticks to the stage's
+ *           histogram, whose buckets are powers of two: bucket n counts durations in
+ *           [2^(n-1), 2^n) ticks, bucket 0 counts zero. There is one bucket per bit of the
+ *           timer, so every duration it can count has a bucket.
+ *
+ *           On the nRF52 TIMER1 runs 32 bits wide at 16 MHz, one tick per four CPU cycles, and
+ *           spans 268 s. On the nRF51 it is only 16 bits wide, so it is prescaled to 1 MHz to
+ *           span 65 ms; short stages lose resolution there.
+ *
+ *           Build with `make PROFILE=1` to enable. Otherwise the macros compile to nothing and
+ *           TIMER1 is not started; a running TIMER keeps the HF clock on, costing sleep current.
+ *
+ * @note     On the nRF51 a stage longer than 65.535 ms aliases into a shorter bucket. The
+ *           maximum recorded is subject to the same limit.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED         0
+#endif
+
+#ifdef NRF51
+#define PROFILE_TIMER_PRESCALER 4                               /**< 16 MHz / 2^4: 1 us ticks */
+#define PROFILE_TIMER_BITS      16
+#else
+#define PROFILE_TIMER_PRESCALER 0                               /**< 16 MHz ticks */
+#define PROFILE_TIMER_BITS      32
+#endif
+
+#define PROFILE_TICKS_PER_US    (16 >> PROFILE_TIMER_PRESCALER)
+#define PROFILE_BUCKETS         (PROFILE_TIMER_BITS + 1)        /**< 0, then one per bit of the timer count */
+
+/**@brief Instrumented stages. */
+typedef enum
+{
+    PROFILE_BLE_EVT_DISPATCH,               // Whole of ble_evt_dispatch
+    PROFILE_ST_CLIENT,                      // st_client_on_ble_evt, including on_hvx and the app handler
+    PROFILE_DECODE,                         // extract_* decoders
+    PROFILE_RULES,                          // rule_engine_evaluate
+    PROFILE_OUTPUT,                         // output_sample: printf or frame encoding
+    PROFILE_STAGE_COUNT
+} profile_stage_t;
+
+#if PROFILE_ENABLED
+
+#include "nrf.h"
+
+/**@brief   Current TIMER1 count. */
+static inline uint32_t profile_now(void)
+{
+    NRF_TIMER1->TASKS_CAPTURE[0] = 1;
+    return NRF_TIMER1->CC[0];
+}
+
+/**@brief   Add the ticks since start to a stage's histogram. */
+void profile_record(profile_stage_t stage, uint32_t start);
+
+#define PROFILE_BEGIN(start)        const uint32_t start = profile_now()
+#define PROFILE_END(stage, start)   profile_record((stage), (start))
+
+#else
+
+#define PROFILE_BEGIN(start)
+#define PROFILE_END(stage, start)
+
+#endif // PROFILE_ENABLED
+
+
+/**@brief   Start TIMER1, if profiling is enabled. */
+void profile_init(void);
+
+/**@brief   Print every stage's histogram, as the UART drains (see output_table).
+ *
+ * @retval  false if a table is still being written.
+ */
+bool profile_dump(void);
+
+/**@brief   Clear all histograms. */
+void profile_reset(void);
+
+#endif // PROFILE_SUPPORT_H
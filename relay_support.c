@@ -0,0 +1,279 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "relay_support.h"
+#include "error_support.h"
+#include "lifecycle_support.h"
+#include "log_support.h"
+#include "stats_support.h"
+
+#include "app_error.h"
+#include "app_timer.h"
+#include "app_util.h"
+#include "ble_advdata.h"
+#include "ble_nus.h"
+
+#define RELAY_DEVICE_NAME       "ST Gateway"                    /**< Advertised name. */
+#define RELAY_ADV_INTERVAL      MSEC_TO_UNITS(300, UNIT_0_625_MS) /**< Advertising interval. */
+#define RELAY_ADV_TIMEOUT       0                               /**< Advertise until a client connects. */
+
+#define RELAY_MIN_CONN_INTERVAL MSEC_TO_UNITS(20, UNIT_1_25_MS) /**< Preferred connection parameters for the client link. */
+#define RELAY_MAX_CONN_INTERVAL MSEC_TO_UNITS(75, UNIT_1_25_MS)
+#define RELAY_SLAVE_LATENCY     0
+#define RELAY_SUP_TIMEOUT       MSEC_TO_UNITS(4000, UNIT_10_MS)
+
+#define RELAY_BUFFER_SIZE       512                             /**< Ring buffer bytes; a power of two. */
+#define RELAY_BATCH_MS          100                             /**< Longest a partial payload waits for more bytes. */
+#define RELAY_ATT_HEADER_LEN    3                               /**< Opcode and handle of a notification. */
+
+// Every caller, UART events included (see uart_init), runs at APP_IRQ_PRIORITY_LOWEST, shared
+// by the BLE and app_timer events, so the ring needs no further protection.
+
+APP_TIMER_DEF(m_batch_timer);
+
+static ble_nus_t            m_nus;
+static relay_rx_handler_t   m_rx_handler;
+static uint16_t             m_conn_handle = BLE_CONN_HANDLE_INVALID;
+static uint16_t             m_payload_len = GATT_MTU_SIZE_DEFAULT - RELAY_ATT_HEADER_LEN;
+
+static uint8_t              m_ring[RELAY_BUFFER_SIZE];
+static uint16_t             m_head;                             // Oldest byte
+static uint16_t             m_count;
+static bool                 m_flush_pending;                    // The batch timer expired while out of TX buffers
+
+
+static void relay_reset(void)
+{
+    m_head = 0;
+    m_count = 0;
+    m_flush_pending = false;
+    UNUSED_VARIABLE(app_timer_stop(m_batch_timer));
+}
+
+/**@brief Send full payloads, and with flush a final partial one, until the SoftDevice is full. */
+static void relay_pump(bool flush)
+{
+    uint8_t packet[RELAY_MAX_ATT_MTU - RELAY_ATT_HEADER_LEN];
+
+    while (m_count >= m_payload_len || (flush && m_count > 0)) {
+        uint16_t len = MIN(m_count, m_payload_len);
+        for (uint16_t i = 0; i < len; ++i) {
+            packet[i] = m_ring[(m_head + i) & (RELAY_BUFFER_SIZE - 1)];
+        }
+
+        ble_gatts_hvx_params_t hvx_params = {
+            .handle = m_nus.rx_handles.value_handle,
+            .type   = BLE_GATT_HVX_NOTIFICATION,
+            .offset = 0,
+            .p_len  = &len,
+            .p_data = packet
+        };
+        uint32_t err_code = sd_ble_gatts_hvx(m_conn_handle, &hvx_params);
+        if (err_code == BLE_ERROR_NO_TX_PACKETS) {
+            m_flush_pending |= flush;
+            return;
+        }
+        if (err_code != NRF_SUCCESS) {
+            // Notifications were disabled or the link is going down; nothing can be sent
+            relay_reset();
+            return;
+        }
+
+        m_head = (m_head + len) & (RELAY_BUFFER_SIZE - 1);
+        m_count -= len;
+        stats_increment(STATS_RELAY_NOTIFICATIONS);
+    }
+    m_flush_pending = false;
+}
+
+static void batch_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    relay_pump(true);
+}
+
+void relay_write(const uint8_t * p_data, uint16_t len)
+{
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID || !m_nus.is_notification_enabled) {
+        return;
+    }
+
+    uint16_t accepted = MIN(len, RELAY_BUFFER_SIZE - m_count);
+    if (accepted < len) {
+        stats_add(STATS_RELAY_DROPPED, len - accepted);
+    }
+    if (m_count == 0 && accepted > 0) {
+        UNUSED_VARIABLE(app_timer_start(m_batch_timer,
+                                        APP_TIMER_TICKS(RELAY_BATCH_MS, APP_TIMER_PRESCALER),
+                                        NULL));
+    }
+    for (uint16_t i = 0; i < accepted; ++i) {
+        m_ring[(m_head + m_count++) & (RELAY_BUFFER_SIZE - 1)] = p_data[i];
+    }
+    relay_pump(false);
+}
+
+static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t length)
+{
+    UNUSED_PARAMETER(p_nus);
+    for (uint16_t i = 0; i < length && m_rx_handler != NULL; ++i) {
+        m_rx_handler(p_data[i]);
+    }
+}
+
+static void advertising_start(void)
+{
+    const ble_gap_adv_params_t adv_params = {
+        .type        = BLE_GAP_ADV_TYPE_ADV_IND,
+        .p_peer_addr = NULL,
+        .fp          = BLE_GAP_ADV_FP_ANY,
+        .interval    = RELAY_ADV_INTERVAL,
+        .timeout     = RELAY_ADV_TIMEOUT
+    };
+
+    uint32_t err_code = sd_ble_gap_adv_start(&adv_params);
+    ERROR_CHECK(ERROR_SITE_RELAY_ADV_START, err_code, advertising_start);
+}
+
+static void gap_params_init(void)
+{
+    uint32_t                err_code;
+    ble_gap_conn_sec_mode_t sec_mode;
+
+    BLE_GAP_CONN_SEC_MODE_SET_OPEN(&sec_mode);
+    err_code = sd_ble_gap_device_name_set(&sec_mode,
+                                          (const uint8_t *)RELAY_DEVICE_NAME,
+                                          strlen(RELAY_DEVICE_NAME));
+    APP_ERROR_CHECK(err_code);
+
+    const ble_gap_conn_params_t gap_conn_params = {
+        .min_conn_interval = RELAY_MIN_CONN_INTERVAL,
+        .max_conn_interval = RELAY_MAX_CONN_INTERVAL,
+        .slave_latency     = RELAY_SLAVE_LATENCY,
+        .conn_sup_timeout  = RELAY_SUP_TIMEOUT
+    };
+    err_code = sd_ble_gap_ppcp_set(&gap_conn_params);
+    APP_ERROR_CHECK(err_code);
+}
+
+static void advertising_init(void)
+{
+    ble_uuid_t adv_uuids[] = { { BLE_UUID_NUS_SERVICE, m_nus.uuid_type } };
+
+    // The name goes in the advertising packet; the 128 bit NUS UUID only fits in the scan response
+    ble_advdata_t advdata;
+    memset(&advdata, 0, sizeof(advdata));
+    advdata.name_type = BLE_ADVDATA_FULL_NAME;
+    advdata.flags     = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+
+    ble_advdata_t scanrsp;
+    memset(&scanrsp, 0, sizeof(scanrsp));
+    scanrsp.uuids_complete.uuid_cnt = ARRAY_SIZE(adv_uuids);
+    scanrsp.uuids_complete.p_uuids  = adv_uuids;
+
+    uint32_t err_code = ble_advdata_set(&advdata, &scanrsp);
+    APP_ERROR_CHECK(err_code);
+}
+
+void relay_init(relay_rx_handler_t rx_handler)
+{
+    uint32_t err_code;
+
+    m_rx_handler = rx_handler;
+
+    gap_params_init();
+
+    const ble_nus_init_t nus_init = { .data_handler = nus_data_handler };
+    err_code = ble_nus_init(&m_nus, &nus_init);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_create(&m_batch_timer, APP_TIMER_MODE_SINGLE_SHOT, batch_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    advertising_init();
+    advertising_start();
+}
+
+void relay_on_ble_evt(ble_evt_t * p_ble_evt)
+{
+    uint32_t err_code;
+    uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        // The relay holds the only GATT server, so it answers for both links; without an answer
+        // the SoftDevice holds back the link's GATT server traffic
+        case BLE_GATTS_EVT_SYS_ATTR_MISSING:
+            // No bonding, so there are no stored CCCD values to restore
+            err_code = sd_ble_gatts_sys_attr_set(conn_handle, NULL, 0, 0);
+            ERROR_CHECK(ERROR_SITE_RELAY_GATTS, err_code, NULL);
+            return;
+#if (NRF_SD_BLE_API_VERSION == 3)
+        case BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST:
+            err_code = sd_ble_gatts_exchange_mtu_reply(conn_handle, RELAY_MAX_ATT_MTU);
+            ERROR_CHECK(ERROR_SITE_RELAY_GATTS, err_code, NULL);
+            if (conn_handle == m_conn_handle) {
+                uint16_t mtu = MIN(p_ble_evt->evt.gatts_evt.params.exchange_mtu_request.client_rx_mtu,
+                                   RELAY_MAX_ATT_MTU);
+                m_payload_len = MAX(mtu, GATT_MTU_SIZE_DEFAULT) - RELAY_ATT_HEADER_LEN;
+            }
+            return;
+#endif
+        case BLE_GAP_EVT_CONNECTED:
+            if (p_ble_evt->evt.gap_evt.params.connected.role != BLE_GAP_ROLE_PERIPH) {
+                return;
+            }
+            LOG("[RELAY]: Client connected");
+            m_conn_handle = conn_handle;
+            m_payload_len = GATT_MTU_SIZE_DEFAULT - RELAY_ATT_HEADER_LEN;
+            relay_reset();
+            stats_increment(STATS_RELAY_CONNECTIONS);
+            break;
+        default:
+            // ble_nus takes the handle of any connection, so keep the SensorTag link away from it
+            if (m_conn_handle == BLE_CONN_HANDLE_INVALID || conn_handle != m_conn_handle) {
+                return;
+            }
+            break;
+    }
+
+    ble_nus_on_ble_evt(&m_nus, p_ble_evt);
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            // ble_nus keeps the flag from the previous client
+            m_nus.is_notification_enabled = false;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            m_conn_handle = BLE_CONN_HANDLE_INVALID;
+            relay_reset();
+            LOG("[RELAY]: Client disconnected");
+            advertising_start();
+            break;
+
+        case BLE_EVT_TX_COMPLETE:
+            relay_pump(m_flush_pending);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,66 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef RELAY_SUPPORT_H
+#define RELAY_SUPPORT_H
+
+/**@file
+ *
+ * @brief    BLE peripheral relay of the gateway output over the Nordic UART Service.
+ *
+ * @details  While the gateway is connected to the SensorTag as a central, it also advertises
+ *           as a peripheral. A Linux client that connects and enables notifications on the NUS
+ *           RX characteristic receives the same byte stream as the UART: samples in the current
+ *           output format, alerts, statistics and diagnostics.
+ *
+ *           Bytes are collected in a ring buffer and sent as notifications of the full ATT
+ *           payload (ATT_MTU - 3), so several samples share one packet. A partial payload is
+ *           sent once RELAY_BATCH_MS has passed since its first byte. When the SoftDevice is
+ *           out of TX buffers the relay waits for BLE_EVT_TX_COMPLETE, and bytes that do not
+ *           fit in the ring are dropped and counted in STATS_RELAY_DROPPED.
+ *
+ *           Bytes the client writes to the NUS TX characteristic are handed to the receive
+ *           handler one at a time, as for the UART.
+ */
+
+#include <stdint.h>
+
+#include "ble.h"
+
+#if (NRF_SD_BLE_API_VERSION == 3)
+#define RELAY_MAX_ATT_MTU       247                             /**< Offered to the client in the ATT MTU exchange. */
+#else
+#define RELAY_MAX_ATT_MTU       GATT_MTU_SIZE_DEFAULT           /**< S130 v2 has a fixed ATT MTU. */
+#endif
+
+/**@brief   Called for each byte the client writes. */
+typedef void (* relay_rx_handler_t)(uint8_t byte);
+
+
+/**@brief   Set up the GAP parameters and the NUS service, and start advertising.
+ *
+ * @details Call after ble_stack_init.
+ *
+ * @param[in] rx_handler    event loop function to handle bytes written by the client
+ */
+void relay_init(relay_rx_handler_t rx_handler);
+
+/**@brief   Queue bytes for the client. Ignored unless a client has enabled notifications. */
+void relay_write(const uint8_t * p_data, uint16_t len);
+
+/**@brief   Handle BLE events for the relay link. Must be called from the BLE event dispatcher. */
+void relay_on_ble_evt(ble_evt_t * p_ble_evt);
+
+#endif // RELAY_SUPPORT_H
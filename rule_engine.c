@@ -0,0 +1,127 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "rule_engine.h"
+
+static inline uint32_t distance(int32_t a, int32_t b)
+{
+    return (a > b) ? (uint32_t)a - (uint32_t)b : (uint32_t)b - (uint32_t)a;
+}
+
+void rule_engine_reset(rule_engine_t * p_engine)
+{
+    memset(p_engine->active, 0, sizeof(p_engine->active));
+    memset(p_engine->streams, 0, sizeof(p_engine->streams));
+}
+
+void rule_engine_init(rule_engine_t * p_engine, const rule_t * p_rules, uint8_t count,
+                      rule_alert_handler_t alert_handler)
+{
+    if (count > RULE_ENGINE_MAX_RULES) {
+        count = RULE_ENGINE_MAX_RULES;
+    }
+    memcpy(p_engine->rules, p_rules, count * sizeof(rule_t));
+    p_engine->rule_count = count;
+    p_engine->alert_handler = alert_handler;
+    rule_engine_reset(p_engine);
+}
+
+/**@brief Work out whether a threshold rule is in alarm after this value. */
+static bool threshold_state(const rule_t * p_rule, bool active, int32_t value)
+{
+    if (p_rule->kind == RULE_THRESHOLD_HIGH) {
+        return active ? (value > p_rule->limit - p_rule->hysteresis) : (value > p_rule->limit);
+    }
+    return active ? (value < p_rule->limit + p_rule->hysteresis) : (value < p_rule->limit);
+}
+
+/**@brief Compare |change| / elapsed against a per-second limit without dividing. */
+static bool rate_exceeded(uint32_t change, uint64_t elapsed, int32_t limit)
+{
+    if (elapsed == 0) {
+        return change != 0;
+    }
+    return (uint64_t)change * RULE_TICKS_PER_SECOND > (uint64_t)limit * elapsed;
+}
+
+bool rule_engine_evaluate(rule_engine_t * p_engine, stream_id_t stream, uint64_t ticks,
+                          const int32_t * p_values)
+{
+    if (stream >= STREAM_COUNT) {
+        return true;
+    }
+    rule_stream_state_t * p_state = &p_engine->streams[stream];
+    const uint8_t count = stream_value_count(stream);
+    bool has_dead_band = false;
+    bool report = !p_state->primed;
+
+    for (uint8_t index = 0; index < p_engine->rule_count; ++index) {
+        const rule_t * p_rule = &p_engine->rules[index];
+        if (p_rule->stream != stream || p_rule->value_index >= count) {
+            continue;
+        }
+        const int32_t value = p_values[p_rule->value_index];
+        bool active = p_engine->active[index];
+
+        switch (p_rule->kind) {
+        case RULE_THRESHOLD_HIGH:
+        case RULE_THRESHOLD_LOW:
+            active = threshold_state(p_rule, active, value);
+            break;
+        case RULE_RATE_OF_CHANGE:
+            active = p_state->primed &&
+                     rate_exceeded(distance(value, p_state->previous[p_rule->value_index]),
+                                   ticks - p_state->previous_ticks, p_rule->limit);
+            break;
+        case RULE_DEAD_BAND:
+            has_dead_band = true;
+            if (distance(value, p_state->reported[p_rule->value_index]) > (uint32_t)p_rule->limit) {
+                report = true;
+            }
+            break;
+        }
+
+        if (active != p_engine->active[index]) {
+            p_engine->active[index] = active;
+            report = true;
+            if (p_engine->alert_handler) {
+                const rule_alert_t alert = {
+                    .rule_index = index,
+                    .p_rule     = p_rule,
+                    .raised     = active,
+                    .value      = value
+                };
+                p_engine->alert_handler(&alert);
+            }
+        }
+    }
+
+    memcpy(p_state->previous, p_values, count * sizeof(int32_t));
+    p_state->previous_ticks = ticks;
+    p_state->primed = true;
+
+    if (!has_dead_band || ++p_state->since_report >= RULE_HEARTBEAT_SAMPLES) {
+        report = true;
+    }
+    if (report) {
+        memcpy(p_state->reported, p_values, count * sizeof(int32_t));
+        p_state->since_report = 0;
+    }
+    return report;
+}
@@ -0,0 +1,127 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef RULE_ENGINE_H
+#define RULE_ENGINE_H
+
+/**@file
+ *
+ * @brief    Report-by-exception rules evaluated on each decoded sample.
+ *
+ * @details  Threshold rules raise an alert when a value crosses their limit and clear it once
+ *           the value has come back by the hysteresis distance. Rate-of-change rules alert when
+ *           a value moves faster than their limit, per second, since the previous sample.
+ *           Dead-band rules do
+ *           not alert; they suppress samples whose value is within the band of the last one
+ *           reported, so that only changes are sent on.
+ *
+ *           Limits are in the stream's raw units (see stream_codec.h), e.g. 1/128 C for
+ *           temperature.
+ *
+ * @note     This module has no SDK dependencies.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stream_codec.h"
+
+#define RULE_ENGINE_MAX_RULES       8
+#define RULE_HEARTBEAT_SAMPLES      60                          /**< A suppressed stream still reports every Nth sample. */
+#define RULE_TICKS_PER_SECOND       32768                       /**< Timestamp units, RTC1 ticks. */
+
+/**@brief Rule kinds. */
+typedef enum
+{
+    RULE_THRESHOLD_HIGH,                    // Alert while value > limit, clear at value <= limit - hysteresis
+    RULE_THRESHOLD_LOW,                     // Alert while value < limit, clear at value >= limit + hysteresis
+    RULE_RATE_OF_CHANGE,                    // Alert when |value - previous| > limit per second
+    RULE_DEAD_BAND,                         // Suppress while |value - reported| <= limit
+} rule_kind_t;
+
+/**@brief A rule on one value of one stream. */
+typedef struct
+{
+    stream_id_t         stream;
+    uint8_t             value_index;
+    rule_kind_t         kind;
+    int32_t             limit;
+    int32_t             hysteresis;
+} rule_t;
+
+/**@brief An alert raised or cleared by a rule. */
+typedef struct
+{
+    uint8_t             rule_index;
+    const rule_t        *p_rule;
+    bool                raised;                                 // true on entering alarm, false on clearing
+    int32_t             value;
+} rule_alert_t;
+
+/**@brief   Called for each alert, before rule_engine_evaluate returns. */
+typedef void (* rule_alert_handler_t)(const rule_alert_t * p_alert);
+
+/**@brief Per-stream reporting state. */
+typedef struct
+{
+    int32_t             previous[STREAM_MAX_VALUES];
+    int32_t             reported[STREAM_MAX_VALUES];
+    uint64_t            previous_ticks;
+    uint16_t            since_report;
+    bool                primed;
+} rule_stream_state_t;
+
+/**@brief Rule engine instance. */
+typedef struct
+{
+    rule_t              rules[RULE_ENGINE_MAX_RULES];
+    bool                active[RULE_ENGINE_MAX_RULES];
+    uint8_t             rule_count;
+    rule_alert_handler_t alert_handler;
+    rule_stream_state_t streams[STREAM_COUNT];
+} rule_engine_t;
+
+
+/**@brief   Initialize the engine with a rule table, which is copied.
+ *
+ * @param[in] p_engine      Engine
+ * @param[in] p_rules       Rules; at most RULE_ENGINE_MAX_RULES are used
+ * @param[in] count         Number of rules
+ * @param[in] alert_handler Called for every alert
+ */
+void rule_engine_init(rule_engine_t * p_engine, const rule_t * p_rules, uint8_t count,
+                      rule_alert_handler_t alert_handler);
+
+/**@brief   Forget all history, e.g. after a disconnect. Active alerts are dropped silently. */
+void rule_engine_reset(rule_engine_t * p_engine);
+
+/**@brief   Evaluate all rules on a sample.
+ *
+ * @details Alerts are delivered through the alert handler. A sample is reported if it is the
+ *          first of its stream, it moved outside a dead-band, it raised or cleared an alert, or
+ *          the stream has been silent for RULE_HEARTBEAT_SAMPLES. Streams without a dead-band
+ *          rule are always reported.
+ *
+ * @param[in] p_engine  Engine
+ * @param[in] stream    Stream of the sample
+ * @param[in] ticks     Sample timestamp, in RULE_TICKS_PER_SECOND
+ * @param[in] p_values  stream_value_count(stream) raw values
+ *
+ * @retval  true if the sample should be reported, false if it is suppressed.
+ */
+bool rule_engine_evaluate(rule_engine_t * p_engine, stream_id_t stream, uint64_t ticks,
+                          const int32_t * p_values);
+
+#endif // RULE_ENGINE_H
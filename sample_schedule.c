@@ -0,0 +1,46 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+
+#include "sample_schedule.h"
+
+uint32_t sample_schedule_offsets(const uint32_t * p_periods, uint8_t count, uint32_t * p_offsets)
+{
+    uint32_t cycle = 0;
+    uint8_t  on = 0;
+
+    for (uint8_t i = 0; i < count; ++i) {
+        if (p_periods[i] != 0) {
+            cycle = (cycle == 0 || p_periods[i] < cycle) ? p_periods[i] : cycle;
+            ++on;
+        }
+    }
+
+    uint8_t slot = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        p_offsets[i] = (p_periods[i] != 0) ? (uint32_t)((uint64_t)cycle * slot++ / on) : 0;
+    }
+    return cycle;
+}
+
+uint64_t sample_schedule_next(uint64_t base, uint32_t cycle, uint32_t offset, uint64_t now)
+{
+    uint64_t at = base + offset;
+    if (cycle == 0 || at >= now) {
+        return at;
+    }
+    return at + (now - at + cycle - 1) / cycle * cycle;
+}
@@ -0,0 +1,58 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef SAMPLE_SCHEDULE_H
+#define SAMPLE_SCHEDULE_H
+
+/**@file
+ *
+ * @brief    Staggers the start of each service's sampling so that notifications interleave.
+ *
+ * @details  The SensorTag starts a sensor's period when its configuration or period is written.
+ *           Services written together therefore notify together, and with equal periods they
+ *           stay together: each burst lands in the output queues at once.
+ *
+ *           The schedule is a grid of cycles, one cycle being the shortest period of the services
+ *           that are on. Each service is given an offset into the cycle, evenly spaced in the
+ *           order of the services, and its writes are held back until the next time the grid
+ *           reaches that offset. Services on one tag share its clock, so the spacing holds for as
+ *           long as the periods stay multiples of the cycle. Other periods still start spread
+ *           out, but drift through each other.
+ *
+ * @note     This module has no SDK dependencies.
+ */
+
+#include <stdint.h>
+
+/**@brief   Lay out the cycle.
+ *
+ * @param[in]  p_periods Period of each service, 0 for a service that is off
+ * @param[in]  count     Number of services
+ * @param[out] p_offsets Offset of each service into the cycle, 0 for a service that is off
+ *
+ * @return  The cycle, the shortest period; 0 if every service is off.
+ */
+uint32_t sample_schedule_offsets(const uint32_t * p_periods, uint8_t count, uint32_t * p_offsets);
+
+/**@brief   The first time at or after now that the grid reaches an offset.
+ *
+ * @param[in] base      Start of a cycle
+ * @param[in] cycle     Length of a cycle, from sample_schedule_offsets
+ * @param[in] offset    Offset into the cycle
+ * @param[in] now       Current time, at or after base
+ */
+uint64_t sample_schedule_next(uint64_t base, uint32_t cycle, uint32_t offset, uint64_t now);
+
+#endif // SAMPLE_SCHEDULE_H
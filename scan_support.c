@@ -49,6 +49,10 @@
 #include <stdbool.h>
 
 #include "scan_support.h"
+#include "adv_parser.h"
+#include "error_support.h"
+#include "log_support.h"
+#include "stats_support.h"
 
 #include "app_util.h"
 #include "bsp.h"
@@ -65,11 +69,10 @@
 #define MIN_CONNECTION_INTERVAL MSEC_TO_UNITS(20, UNIT_1_25_MS) /**< Determines minimum connection interval in millisecond. */
 #define MAX_CONNECTION_INTERVAL MSEC_TO_UNITS(75, UNIT_1_25_MS) /**< Determines maximum connection interval in millisecond. */
 #define SLAVE_LATENCY           0                               /**< Determines slave latency in counts of connection events. */
-#define SUPERVISION_TIMEOUT     MSEC_TO_UNITS(4000, UNIT_10_MS) /**< Determines supervision time-out in units of 10 millisecond. */
+#define SUPERVISION_TIMEOUT     MSEC_TO_UNITS(1000, UNIT_10_MS) /**< Determines supervision time-out in units of 10 millisecond. */
+
+#define RECONNECT_TIMEOUT       2                               /**< Seconds to wait for the last peer before scanning again. */
 
-#define UUID16_SIZE             2                               /**< Size of 16 bit UUID */
-#define UUID32_SIZE             4                               /**< Size of 32 bit UUID */
-#define UUID128_SIZE            16                              /**< Size of 128 bit UUID */
 #define VS_UUID_COUNT           4
 
 
@@ -90,23 +93,49 @@ static const ble_gap_conn_params_t m_connection_param =
 static const ble_gap_scan_params_t m_scan_params = 
   {
     .active      = SCAN_ACTIVE,
+#if (NRF_SD_BLE_API_VERSION == 2)
     .selective   = SCAN_SELECTIVE,
     .p_whitelist = NULL,
+#endif
+#if (NRF_SD_BLE_API_VERSION == 3)
+    .use_whitelist = SCAN_SELECTIVE,
+#endif
     .interval    = SCAN_INTERVAL,
     .window      = SCAN_WINDOW,
     .timeout     = SCAN_TIMEOUT
   };
 
+/**
+ * @brief Parameters used when reconnecting to the last peer: the timeout ends the attempt.
+ */
+static const ble_gap_scan_params_t m_reconnect_params = 
+  {
+    .active      = SCAN_ACTIVE,
+#if (NRF_SD_BLE_API_VERSION == 2)
+    .selective   = SCAN_SELECTIVE,
+    .p_whitelist = NULL,
+#endif
+#if (NRF_SD_BLE_API_VERSION == 3)
+    .use_whitelist = SCAN_SELECTIVE,
+#endif
+    .interval    = SCAN_INTERVAL,
+    .window      = SCAN_WINDOW,
+    .timeout     = RECONNECT_TIMEOUT
+  };
+
 
 void scan_start(void)
 {
     uint32_t err_code;
     
+    // NRF_ERROR_INVALID_STATE: already scanning, or a connection request is pending
     err_code = sd_ble_gap_scan_start(&m_scan_params);
-    APP_ERROR_CHECK(err_code);
+    if (!ERROR_CHECK(ERROR_SITE_SCAN_START, err_code, scan_start)) {
+        return;
+    }
     
     err_code = bsp_indication_set(BSP_INDICATE_SCANNING);
-    APP_ERROR_CHECK(err_code);
+    ERROR_CHECK(ERROR_SITE_INDICATION, err_code, NULL);
 }
 
 void connect_peer(const ble_gap_addr_t* p_gap_address)
@@ -117,87 +146,61 @@ void connect_peer(const ble_gap_addr_t* p_gap_address)
                                   &m_connection_param);
 
     // NRF_SUCCESS == 'connecting' not 'connected' 
-    if (err_code == NRF_SUCCESS)
+    if (ERROR_CHECK(ERROR_SITE_CONNECT, err_code, NULL))
     {
         // scan is automatically stopped by the connect
+        stats_increment(STATS_CONNECT_ATTEMPTS);
         err_code = bsp_indication_set(BSP_INDICATE_IDLE);
         
-        APP_ERROR_CHECK(err_code);
-        printf("Connecting to target %02x:%02x:%02x:%02x:%02x:%02x\r\n",
-                 p_gap_address->addr[0],
-                 p_gap_address->addr[1],
-                 p_gap_address->addr[2],
-                 p_gap_address->addr[3],
-                 p_gap_address->addr[4],
-                 p_gap_address->addr[5]
-                 );
+        ERROR_CHECK(ERROR_SITE_INDICATION, err_code, NULL);
+        LOG("Connecting to target %02x:%02x:%02x:%02x:%02x:%02x",
+            p_gap_address->addr[0],
+            p_gap_address->addr[1],
+            p_gap_address->addr[2],
+            p_gap_address->addr[3],
+            p_gap_address->addr[4],
+            p_gap_address->addr[5]);
     }
 
 }
 
-bool compare_uuid(uint8_t *p_data, const ble_uuid_t* p_target_uuid, uint8_t index, uint8_t field_length, uint8_t stride_size, uint8_t decode_size)
+bool reconnect_peer(const ble_gap_addr_t* p_gap_address)
 {
-    ble_uuid_t extracted_uuid; 
-    uint32_t error_code;
+    uint32_t err_code = sd_ble_gap_connect(p_gap_address,
+                                           &m_reconnect_params,
+                                           &m_connection_param);
+    if (!ERROR_CHECK(ERROR_SITE_CONNECT, err_code, NULL)) {
+        return false;
+    }
+    stats_increment(STATS_CONNECT_ATTEMPTS);
+    err_code = bsp_indication_set(BSP_INDICATE_IDLE);
+    ERROR_CHECK(ERROR_SITE_INDICATION, err_code, NULL);
+    LOG("Reconnecting to target");
+    return true;
+}
 
-    for (uint32_t u_index = 0; u_index < (field_length/stride_size); u_index++)
-    {
-        error_code = sd_ble_uuid_decode(decode_size, 
-                                        &p_data[u_index * stride_size + index + 2], 
-                                        &extracted_uuid);
-        if (error_code == NRF_SUCCESS)
-        {  
-            if ((extracted_uuid.uuid == p_target_uuid->uuid)
-                && (extracted_uuid.type == BLE_UUID_TYPE_BLE ))
-            {
-                return true;
-            }
-        }
+void conn_params_limit(ble_gap_conn_params_t* p_conn_params)
+{
+    // The timeout must exceed two connection intervals, each stretched by the slave latency
+    uint32_t floor = (1 + p_conn_params->slave_latency) * p_conn_params->max_conn_interval / 4 + 1;
+    if (p_conn_params->conn_sup_timeout > SUPERVISION_TIMEOUT) {
+        p_conn_params->conn_sup_timeout = (uint16_t)MAX(floor, SUPERVISION_TIMEOUT);
     }
-    return false;
 }
 
 bool is_uuid_present(const ble_uuid_t *p_target_uuid, 
                      const ble_gap_evt_adv_report_t *p_adv_report)
 {
-    uint32_t index = 0;
-    uint8_t *p_data = (uint8_t *)p_adv_report->data;
-    while (index < p_adv_report->dlen)
+    uint16_t offset = 0;
+    adv_field_t field;
+    while (adv_field_next(p_adv_report->data, p_adv_report->dlen, &offset, &field))
     {
-        uint8_t field_length = p_data[index];
-        uint8_t field_type   = p_data[index+1];
-        bool found = false;
-
-        switch (field_type) {
-            case BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE:
-            case BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE:
-                found = compare_uuid(p_data, p_target_uuid, index, field_length, 
-                                     UUID16_SIZE, UUID16_SIZE);
-                break;
-            case BLE_GAP_AD_TYPE_32BIT_SERVICE_UUID_MORE_AVAILABLE:
-            case BLE_GAP_AD_TYPE_32BIT_SERVICE_UUID_COMPLETE:
-                found = compare_uuid(p_data, p_target_uuid, index, field_length, 
-                                     UUID32_SIZE, UUID16_SIZE);
-                break;
-            case BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_MORE_AVAILABLE:
-            case BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE:
-                found = compare_uuid(p_data, p_target_uuid, index, field_length, 
-                                     UUID128_SIZE, UUID128_SIZE);
-                break;
-            case BLE_GAP_AD_TYPE_SHORT_LOCAL_NAME:
-            case BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME:
-                printf("Local name: ");
-                for (int i = index + 2; i < index + field_length + 1; ++i) {
-                    putc(p_data[i], stdout);
-                }
-                putc('\n', stdout);
-                break;
+        if (field.type == ADV_TYPE_SHORT_LOCAL_NAME || field.type == ADV_TYPE_COMPLETE_LOCAL_NAME) {
+            printf("Local name: %.*s\n", field.len, (const char *)field.p_data);
         }
-        if (found) {
+        else if (adv_field_has_uuid16(&field, p_target_uuid->uuid)) {
             return true;
         }
-        // The field_length byte does not contribute to the field_length value, the field_type byte does
-        index += field_length + 1;
     }
     return false;
 }
@@ -67,6 +67,29 @@ void scan_start(void);
 void connect_peer(const ble_gap_addr_t* p_gap_address);
 
 
+/**@brief   Attempts to reconnect to a known peer without scanning for it first.
+ *
+ * @details The request times out after RECONNECT_TIMEOUT with a BLE_GAP_EVT_TIMEOUT
+ *          (BLE_GAP_TIMEOUT_SRC_CONN), and the caller should fall back to scan_start.
+ *
+ * @param[in]   p_gap_address The address of the last connected peer
+ *
+ * @retval      true if the connection request was issued.
+ */
+bool reconnect_peer(const ble_gap_addr_t* p_gap_address);
+
+
+/**@brief   Limits the supervision timeout of parameters requested by the peer.
+ *
+ * @details A long supervision timeout delays the detection of a lost link by as much. The
+ *          timeout is lowered to SUPERVISION_TIMEOUT where the requested interval and slave
+ *          latency allow it.
+ *
+ * @param[in,out] p_conn_params Parameters from a BLE_GAP_EVT_CONN_PARAM_UPDATE_REQUEST
+ */
+void conn_params_limit(ble_gap_conn_params_t* p_conn_params);
+
+
 /**@brief Reads an advertising report and checks if a uuid is present in the service list.
  *
  * @details The function is able to search for 16-bit, 32-bit and 128-bit service uuids. 
@@ -0,0 +1,79 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "sensortag_payload.h"
+
+static const st_payload_def_t m_payload_defs[STREAM_COUNT] = {
+    [STREAM_LUXO] = {
+        // One unsigned word, reported unscaled
+        .name        = "luxo",
+        .len         = 2,
+        .exact_len   = false,
+        .value_count = 1,
+        .is_signed   = false,
+        .value_names = { "raw" },
+        .scale       = 1.0f,
+        .unit        = "raw",
+    },
+    [STREAM_TEMP] = {
+        // Two signed words, IR then ambient; the scaling factor 'ECG patch' is 0.0078125
+        .name        = "temp",
+        .len         = 4,
+        .exact_len   = true,
+        .value_count = 2,
+        .is_signed   = true,
+        .value_names = { "ir", "amb" },
+        .scale       = ST_PAYLOAD_TEMP_SCALE,
+        .unit        = "C",
+    },
+};
+
+const st_payload_def_t * st_payload_def(stream_id_t stream)
+{
+    return (stream < STREAM_COUNT) ? &m_payload_defs[stream] : NULL;
+}
+
+stream_id_t st_payload_find(const char * p_name)
+{
+    for (int stream = 0; stream < STREAM_COUNT; ++stream) {
+        if (strcmp(p_name, m_payload_defs[stream].name) == 0) {
+            return stream;
+        }
+    }
+    return STREAM_COUNT;
+}
+
+bool st_payload_decode(stream_id_t stream, const uint8_t * p_data, uint16_t len, int32_t * p_values)
+{
+    const st_payload_def_t * p_def = st_payload_def(stream);
+    if (p_def == NULL || p_data == NULL || len < p_def->len || (p_def->exact_len && len != p_def->len)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < p_def->value_count; ++i) {
+        // Byte reads: notification data has no alignment guarantee
+        uint16_t word = (uint16_t)(p_data[2 * i] | (p_data[2 * i + 1] << 8));
+        p_values[i] = p_def->is_signed ? (int32_t)(int16_t)word : (int32_t)word;
+    }
+    return true;
+}
+
+float st_payload_scale(stream_id_t stream, int32_t raw)
+{
+    const st_payload_def_t * p_def = st_payload_def(stream);
+    return p_def ? p_def->scale * raw : 0.0f;
+}
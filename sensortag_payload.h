@@ -0,0 +1,72 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef SENSORTAG_PAYLOAD_H
+#define SENSORTAG_PAYLOAD_H
+
+/**@file
+ *
+ * @brief    Layout and scaling of the SensorTag DATA notifications.
+ *
+ * @details  One definition per stream (SensorTag service): how many bytes a notification
+ *           carries, how they split into sensor words, and how a word converts to units. The
+ *           firmware's extract_*_data helpers and the Linux tools in host/ both decode through
+ *           this table, so the two can never disagree about what a sample means.
+ *
+ * @note     This module has no SDK dependencies; the Linux tools in host/ build the same source.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stream_codec.h"
+
+#define ST_PAYLOAD_TEMP_SCALE       0.0078125f                  /**< 1/128 C per count, both sensors. */
+
+/**@brief Definition of one service's DATA payload. */
+typedef struct
+{
+    const char          *name;                  // Stream name, as used by commands and traces
+    uint8_t             len;                    // Bytes needed in a notification
+    bool                exact_len;              // Longer notifications are rejected too
+    uint8_t             value_count;            // Little endian 16 bit words, one per value
+    bool                is_signed;
+    const char          *value_names[STREAM_MAX_VALUES];
+    float               scale;                  // Units per count
+    const char          *unit;
+} st_payload_def_t;
+
+/**@brief   Payload definition of a stream, or NULL if the stream is unknown. */
+const st_payload_def_t * st_payload_def(stream_id_t stream);
+
+/**@brief   Stream with the given name, or STREAM_COUNT if there is none. */
+stream_id_t st_payload_find(const char * p_name);
+
+/**@brief   Split a notification into sensor words.
+ *
+ * @param[in]  stream    Stream the notification belongs to
+ * @param[in]  p_data    Notification value; no alignment required
+ * @param[in]  len       Length of p_data
+ * @param[out] p_values  st_payload_def(stream)->value_count words
+ *
+ * @retval     true if the notification had the payload's length; longer ones are accepted
+ *             unless the definition has exact_len.
+ */
+bool st_payload_decode(stream_id_t stream, const uint8_t * p_data, uint16_t len, int32_t * p_values);
+
+/**@brief   Convert a sensor word of the stream to units. */
+float st_payload_scale(stream_id_t stream, int32_t raw);
+
+#endif // SENSORTAG_PAYLOAD_H
@@ -0,0 +1,171 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "stats_support.h"
+#include "output_support.h"
+#include "time_support.h"
+
+#include "ble_hci.h"
+
+static uint32_t m_counters[STATS_COUNTER_COUNT];
+static uint64_t m_discovery_start;
+static bool     m_discovery_running;
+static uint64_t m_gap_start;
+static bool     m_gap_running;
+
+static const char * const m_counter_names[STATS_COUNTER_COUNT] = {
+    [STATS_NOTIFY_LUXO]            = "notify_luxo",
+    [STATS_NOTIFY_TEMP]            = "notify_temp",
+    [STATS_DECODE_FAILED]          = "decode_failed",
+    [STATS_SAMPLES_SUPPRESSED]     = "suppressed",
+    [STATS_UART_DROPPED]           = "uart_dropped",
+    [STATS_CONNECT_ATTEMPTS]       = "connect_attempts",
+    [STATS_CONNECT_TIMEOUTS]       = "connect_timeouts",
+    [STATS_CONNECTIONS]            = "connections",
+    [STATS_DISCOVERY_LAST_MS]      = "discovery_last_ms",
+    [STATS_DISCOVERY_MAX_MS]       = "discovery_max_ms",
+    [STATS_DISCONNECT_SUPERVISION] = "disc_supervision",
+    [STATS_DISCONNECT_REMOTE]      = "disc_remote",
+    [STATS_DISCONNECT_LOCAL]       = "disc_local",
+    [STATS_DISCONNECT_FAILED]      = "disc_failed",
+    [STATS_DISCONNECT_OTHER]       = "disc_other",
+    [STATS_DISCONNECT_LAST_REASON] = "disc_last_reason",
+    [STATS_UART_RX_ERRORS]         = "uart_rx_errors",
+    [STATS_RELAY_CONNECTIONS]      = "relay_connections",
+    [STATS_RELAY_NOTIFICATIONS]    = "relay_notifications",
+    [STATS_RELAY_DROPPED]          = "relay_dropped",
+    [STATS_ERROR_SCAN_START]       = "err_scan_start",
+    [STATS_ERROR_CONNECT]          = "err_connect",
+    [STATS_ERROR_DISCOVERY_START]  = "err_discovery",
+    [STATS_ERROR_SERVICE_CONFIGURE] = "err_configure",
+    [STATS_ERROR_DISCONNECT]       = "err_disconnect",
+    [STATS_ERROR_SEC_PARAMS_REPLY] = "err_sec_params",
+    [STATS_ERROR_CONN_PARAM_UPDATE] = "err_conn_param",
+    [STATS_ERROR_INDICATION]       = "err_indication",
+    [STATS_ERROR_RELAY_ADV_START]  = "err_relay_adv",
+    [STATS_ERROR_RELAY_GATTS]      = "err_relay_gatts",
+    [STATS_ERROR_RETRIES]          = "err_retries",
+    [STATS_ERROR_ROLLBACKS]        = "err_rollbacks",
+    [STATS_ERROR_LAST_CODE]        = "err_last_code",
+    [STATS_WATCHDOG_REENABLES]     = "wdog_reenables",
+    [STATS_WATCHDOG_DISCONNECTS]   = "wdog_disconnects",
+    [STATS_RECONNECT_DIRECT]       = "reconnect_direct",
+    [STATS_RECONNECT_FALLBACK]     = "reconnect_fallback",
+    [STATS_GAP_LAST_MS]            = "gap_last_ms",
+    [STATS_GAP_MAX_MS]             = "gap_max_ms",
+    [STATS_GAP_TOTAL_MS]           = "gap_total_ms",
+    [STATS_BACKPRESSURE_SLOWDOWNS] = "bp_slowdowns",
+    [STATS_BACKPRESSURE_LEVEL]     = "bp_level",
+};
+
+
+void stats_increment(stats_counter_t counter)
+{
+    ++m_counters[counter];
+}
+
+void stats_add(stats_counter_t counter, uint32_t n)
+{
+    m_counters[counter] += n;
+}
+
+uint32_t stats_get(stats_counter_t counter)
+{
+    return m_counters[counter];
+}
+
+void stats_set(stats_counter_t counter, uint32_t value)
+{
+    m_counters[counter] = value;
+}
+
+void stats_discovery_started(uint64_t ticks)
+{
+    m_discovery_start = ticks;
+    m_discovery_running = true;
+}
+
+void stats_discovery_finished(uint64_t ticks)
+{
+    if (!m_discovery_running) {
+        return;
+    }
+    m_discovery_running = false;
+
+    uint32_t ms = (uint32_t)((ticks - m_discovery_start) * 1000 / TIME_TICKS_PER_SECOND);
+    m_counters[STATS_DISCOVERY_LAST_MS] = ms;
+    if (ms > m_counters[STATS_DISCOVERY_MAX_MS]) {
+        m_counters[STATS_DISCOVERY_MAX_MS] = ms;
+    }
+}
+
+void stats_gap_started(uint64_t ticks)
+{
+    m_gap_start = ticks;
+    m_gap_running = true;
+}
+
+void stats_gap_finished(uint64_t ticks)
+{
+    if (!m_gap_running) {
+        return;
+    }
+    m_gap_running = false;
+
+    uint32_t ms = (uint32_t)((ticks - m_gap_start) * 1000 / TIME_TICKS_PER_SECOND);
+    m_counters[STATS_GAP_LAST_MS] = ms;
+    m_counters[STATS_GAP_TOTAL_MS] += ms;
+    if (ms > m_counters[STATS_GAP_MAX_MS]) {
+        m_counters[STATS_GAP_MAX_MS] = ms;
+    }
+}
+
+void stats_disconnect(uint8_t reason)
+{
+    switch (reason)
+    {
+        case BLE_HCI_CONNECTION_TIMEOUT:
+            ++m_counters[STATS_DISCONNECT_SUPERVISION];
+            break;
+        case BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION:
+            ++m_counters[STATS_DISCONNECT_REMOTE];
+            break;
+        case BLE_HCI_LOCAL_HOST_TERMINATED_CONNECTION:
+            ++m_counters[STATS_DISCONNECT_LOCAL];
+            break;
+        case BLE_HCI_CONN_FAILED_TO_BE_ESTABLISHED:
+            ++m_counters[STATS_DISCONNECT_FAILED];
+            break;
+        default:
+            ++m_counters[STATS_DISCONNECT_OTHER];
+            break;
+    }
+    m_counters[STATS_DISCONNECT_LAST_REASON] = reason;
+    m_discovery_running = false;
+}
+
+bool stats_dump(void)
+{
+    return output_stats(m_counter_names, m_counters, STATS_COUNTER_COUNT);
+}
+
+void stats_reset(void)
+{
+    memset(m_counters, 0, sizeof(m_counters));
+}
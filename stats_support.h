@@ -0,0 +1,126 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef STATS_SUPPORT_H
+#define STATS_SUPPORT_H
+
+/**@file
+ *
+ * @brief    Runtime counters for remote diagnosis.
+ *
+ * @details  Counters are plain 32 bit words. On both the nRF51 and the nRF52 every writer (BLE
+ *           events, app_timer, UART events) runs at APP_IRQ_PRIORITY_LOWEST (see uart_init), so
+ *           none preempts another and an increment needs no critical region. The counters wrap
+ *           silently.
+ *
+ *           stats_dump writes them in the current output format: [STATS] lines in text mode,
+ *           STREAM_FRAME_STATS frames in compressed mode. The table is paced to the bulk lane
+ *           (see output_stats), so a dump never drops output or triggers backpressure.
+ */
+
+#include <stdint.h>
+
+/**@brief Counters, in the order they are dumped. Append only: the index is part of the binary dump. */
+typedef enum
+{
+    STATS_NOTIFY_LUXO,                      // Luxometer notifications received
+    STATS_NOTIFY_TEMP,                      // Temperature notifications received
+    STATS_DECODE_FAILED,                    // Notifications whose payload did not decode (valid == false)
+    STATS_SAMPLES_SUPPRESSED,               // Samples held back by a dead-band rule
+    STATS_UART_DROPPED,                     // Output bytes lost because the UART FIFO was full
+    STATS_CONNECT_ATTEMPTS,                 // Connection requests accepted by the SoftDevice
+    STATS_CONNECT_TIMEOUTS,                 // Connection requests that timed out
+    STATS_CONNECTIONS,                      // Connections established
+    STATS_DISCOVERY_LAST_MS,                // Duration of the most recent service discovery
+    STATS_DISCOVERY_MAX_MS,                 // Longest service discovery
+    STATS_DISCONNECT_SUPERVISION,           // Disconnects with reason BLE_HCI_CONNECTION_TIMEOUT
+    STATS_DISCONNECT_REMOTE,                // ... BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION
+    STATS_DISCONNECT_LOCAL,                 // ... BLE_HCI_LOCAL_HOST_TERMINATED_CONNECTION
+    STATS_DISCONNECT_FAILED,                // ... BLE_HCI_CONN_FAILED_TO_BE_ESTABLISHED
+    STATS_DISCONNECT_OTHER,                 // ... any other reason
+    STATS_DISCONNECT_LAST_REASON,           // HCI reason of the most recent disconnect
+    STATS_UART_RX_ERRORS,                   // Framing, parity, overrun or break on UART receive (nRF52)
+    STATS_RELAY_CONNECTIONS,                // Relay clients connected
+    STATS_RELAY_NOTIFICATIONS,              // Notifications sent to relay clients
+    STATS_RELAY_DROPPED,                    // Bytes lost because the relay buffer was full
+    STATS_ERROR_SCAN_START,                 // Recovered errors per site, see error_support.h
+    STATS_ERROR_CONNECT,
+    STATS_ERROR_DISCOVERY_START,
+    STATS_ERROR_SERVICE_CONFIGURE,
+    STATS_ERROR_DISCONNECT,
+    STATS_ERROR_SEC_PARAMS_REPLY,
+    STATS_ERROR_CONN_PARAM_UPDATE,
+    STATS_ERROR_INDICATION,
+    STATS_ERROR_RELAY_ADV_START,
+    STATS_ERROR_RELAY_GATTS,
+    STATS_ERROR_RETRIES,                    // Operations scheduled to run again
+    STATS_ERROR_ROLLBACKS,                  // Links dropped, or scans restarted, to recover
+    STATS_ERROR_LAST_CODE,                  // Most recent recovered error code
+    STATS_WATCHDOG_REENABLES,               // Services enabled again after missing notifications
+    STATS_WATCHDOG_DISCONNECTS,             // Links dropped because a service stayed silent
+    STATS_RECONNECT_DIRECT,                 // Directed reconnects to the last SensorTag
+    STATS_RECONNECT_FALLBACK,               // Directed reconnects that timed out and fell back to scanning
+    STATS_GAP_LAST_MS,                      // Data gap of the most recent link loss: last sample to next sample
+    STATS_GAP_MAX_MS,                       // Longest data gap
+    STATS_GAP_TOTAL_MS,                     // Sum of the data gaps
+    STATS_BACKPRESSURE_SLOWDOWNS,           // Sampling slowed down because the UART could not keep up
+    STATS_BACKPRESSURE_LEVEL,               // Current slowdown: sampling periods are stretched 2^level times
+    STATS_COUNTER_COUNT
+} stats_counter_t;
+
+
+/**@brief   Add one to a counter. */
+void stats_increment(stats_counter_t counter);
+
+/**@brief   Add n to a counter. */
+void stats_add(stats_counter_t counter, uint32_t n);
+
+/**@brief   Current value of a counter. */
+uint32_t stats_get(stats_counter_t counter);
+
+/**@brief   Overwrite a counter that holds a value rather than a count. */
+void stats_set(stats_counter_t counter, uint32_t value);
+
+/**@brief   Note the start of service discovery.
+ *
+ * @param[in] ticks     Current time, see time_support_now
+ */
+void stats_discovery_started(uint64_t ticks);
+
+/**@brief   Note the end of service discovery and record its duration. */
+void stats_discovery_finished(uint64_t ticks);
+
+/**@brief   Note a link loss, when data stops until the next sample.
+ *
+ * @param[in] ticks     Receive time of the last sample before the link was lost
+ */
+void stats_gap_started(uint64_t ticks);
+
+/**@brief   Note a sample and, after a link loss, record the length of the gap. */
+void stats_gap_finished(uint64_t ticks);
+
+/**@brief   Count a disconnect under its HCI reason. */
+void stats_disconnect(uint8_t reason);
+
+/**@brief   Write every counter to the output stream, as the UART drains.
+ *
+ * @retval  false if a table is still being written.
+ */
+bool stats_dump(void);
+
+/**@brief   Zero every counter. */
+void stats_reset(void);
+
+#endif // STATS_SUPPORT_H
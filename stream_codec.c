@@ -0,0 +1,567 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "stream_codec.h"
+
+#define RECORD_STREAM_MASK      0x07
+#define RECORD_KIND_SHIFT       3
+#define RECORD_KIND_MASK        0x03
+#define RECORD_INLINE_SHIFT     5
+#define RECORD_INLINE_MAX       7
+#define RECORD_SEQ_LEN          3                               /**< Header and a 16 bit sequence number. */
+
+static const uint8_t m_value_counts[STREAM_COUNT] = {
+    [STREAM_LUXO] = 1,
+    [STREAM_TEMP] = 2,
+};
+
+uint8_t stream_value_count(stream_id_t stream)
+{
+    return (stream < STREAM_COUNT) ? m_value_counts[stream] : 0;
+}
+
+// Primitives ---------------------------------------------------------------------------------------
+
+uint16_t stream_crc16(const uint8_t * p_data, uint16_t len, uint16_t crc)
+{
+    for (uint16_t i = 0; i < len; ++i) {
+        crc  = (uint8_t)(crc >> 8) | (crc << 8);
+        crc ^= p_data[i];
+        crc ^= (uint8_t)(crc & 0xFF) >> 4;
+        crc ^= (crc << 8) << 4;
+        crc ^= ((crc & 0xFF) << 4) << 1;
+    }
+    return crc;
+}
+
+static inline uint32_t zigzag_encode(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t zigzag_decode(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static inline uint8_t varint_len(uint32_t value)
+{
+    uint8_t len = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++len;
+    }
+    return len;
+}
+
+static inline uint8_t varint_put(uint8_t * p_out, uint32_t value)
+{
+    uint8_t len = 0;
+    while (value >= 0x80) {
+        p_out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p_out[len++] = (uint8_t)value;
+    return len;
+}
+
+static inline uint8_t varint64_len(uint64_t value)
+{
+    uint8_t len = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++len;
+    }
+    return len;
+}
+
+static inline uint8_t varint64_put(uint8_t * p_out, uint64_t value)
+{
+    uint8_t len = 0;
+    while (value >= 0x80) {
+        p_out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p_out[len++] = (uint8_t)value;
+    return len;
+}
+
+static bool varint64_get(const uint8_t * p_data, uint16_t len, uint16_t * p_index, uint64_t * p_value)
+{
+    uint64_t value = 0;
+    for (uint8_t shift = 0; shift < 7 * STREAM_VARINT64_MAX_LEN; shift += 7) {
+        if (*p_index >= len) {
+            return false;
+        }
+        uint8_t byte = p_data[(*p_index)++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *p_value = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool varint_get(const uint8_t * p_data, uint16_t len, uint16_t * p_index, uint32_t * p_value)
+{
+    uint32_t value = 0;
+    for (uint8_t shift = 0; shift < 7 * STREAM_VARINT_MAX_LEN; shift += 7) {
+        if (*p_index >= len) {
+            return false;
+        }
+        uint8_t byte = p_data[(*p_index)++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *p_value = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint8_t record_header(stream_id_t stream, stream_record_kind_t kind, uint8_t inline_arg)
+{
+    return (uint8_t)(stream | (kind << RECORD_KIND_SHIFT) | (inline_arg << RECORD_INLINE_SHIFT));
+}
+
+// Framing ------------------------------------------------------------------------------------------
+
+uint16_t stream_frame_encode(uint8_t type, uint8_t frame_seq,
+                             const uint8_t * p_payload, uint16_t len, uint8_t * p_out)
+{
+    if (len > STREAM_FRAME_MAX_PAYLOAD) {
+        return 0;
+    }
+
+    uint8_t body[STREAM_FRAME_MAX_BODY];
+    uint16_t body_len = 0;
+    body[body_len++] = type;
+    body[body_len++] = frame_seq;
+    memcpy(&body[body_len], p_payload, len);
+    body_len += len;
+    uint16_t crc = stream_crc16(body, body_len, 0xFFFF);
+    body[body_len++] = (uint8_t)crc;
+    body[body_len++] = (uint8_t)(crc >> 8);
+
+    // COBS: each code byte gives the distance to the next zero, which it replaces
+    uint16_t pos = 0;
+    p_out[pos++] = STREAM_FRAME_DELIMITER;
+    uint16_t code_pos = pos++;
+    uint8_t code = 1;
+    for (uint16_t i = 0; i < body_len; ++i) {
+        if (body[i] == 0) {
+            p_out[code_pos] = code;
+            code_pos = pos++;
+            code = 1;
+        }
+        else {
+            p_out[pos++] = body[i];
+            if (++code == 0xFF) {
+                p_out[code_pos] = code;
+                code_pos = pos++;
+                code = 1;
+            }
+        }
+    }
+    p_out[code_pos] = code;
+    p_out[pos++] = STREAM_FRAME_DELIMITER;
+    return pos;
+}
+
+bool stream_frame_decode(uint8_t * p_buf, uint16_t len, stream_frame_t * p_frame)
+{
+    uint16_t read = 0;
+    uint16_t write = 0;
+    while (read < len) {
+        uint8_t code = p_buf[read++];
+        if (code == 0) {
+            return false;
+        }
+        for (uint8_t i = 1; i < code; ++i) {
+            if (read >= len) {
+                return false;
+            }
+            p_buf[write++] = p_buf[read++];
+        }
+        if (code != 0xFF && read < len) {
+            p_buf[write++] = 0;
+        }
+    }
+    if (write < STREAM_FRAME_HEADER_LEN + STREAM_FRAME_CRC_LEN) {
+        return false;
+    }
+
+    uint16_t body_len = write - STREAM_FRAME_CRC_LEN;
+    uint16_t crc = p_buf[body_len] | (p_buf[body_len + 1] << 8);
+    if (stream_crc16(p_buf, body_len, 0xFFFF) != crc) {
+        return false;
+    }
+
+    p_frame->type      = p_buf[0];
+    p_frame->frame_seq = p_buf[1];
+    p_frame->p_payload = &p_buf[STREAM_FRAME_HEADER_LEN];
+    p_frame->len       = body_len - STREAM_FRAME_HEADER_LEN;
+    return true;
+}
+
+stream_seq_space_t stream_frame_seq_space(uint8_t type)
+{
+    return (type == STREAM_FRAME_ALERT || type == STREAM_FRAME_LOG) ? STREAM_SEQ_URGENT : STREAM_SEQ_FRAMES;
+}
+
+// Alerts -------------------------------------------------------------------------------------------
+
+uint16_t stream_alert_encode(const stream_alert_t * p_alert, uint8_t frame_seq, uint8_t * p_out)
+{
+    uint8_t payload[5 + STREAM_VARINT_MAX_LEN];
+    uint16_t len = 0;
+    payload[len++] = p_alert->rule_index;
+    payload[len++] = p_alert->stream;
+    payload[len++] = p_alert->value_index;
+    payload[len++] = p_alert->kind;
+    payload[len++] = p_alert->raised ? 1 : 0;
+    len += varint_put(&payload[len], zigzag_encode(p_alert->value));
+    return stream_frame_encode(STREAM_FRAME_ALERT, frame_seq, payload, len, p_out);
+}
+
+bool stream_alert_decode(const stream_frame_t * p_frame, stream_alert_t * p_alert)
+{
+    uint16_t index = 5;
+    uint32_t value;
+    if (p_frame->type != STREAM_FRAME_ALERT || p_frame->len < index ||
+        !varint_get(p_frame->p_payload, p_frame->len, &index, &value))
+    {
+        return false;
+    }
+    p_alert->rule_index  = p_frame->p_payload[0];
+    p_alert->stream      = p_frame->p_payload[1];
+    p_alert->value_index = p_frame->p_payload[2];
+    p_alert->kind        = p_frame->p_payload[3];
+    p_alert->raised      = p_frame->p_payload[4] != 0;
+    p_alert->value       = zigzag_decode(value);
+    return true;
+}
+
+// Logs ---------------------------------------------------------------------------------------------
+
+uint16_t stream_log_encode(const stream_log_t * p_log, uint8_t frame_seq, uint8_t * p_out)
+{
+    uint8_t payload[(1 + STREAM_LOG_MAX_ARGS) * STREAM_VARINT_MAX_LEN];
+    uint16_t len = varint_put(payload, p_log->token);
+    for (uint8_t i = 0; i < p_log->count && i < STREAM_LOG_MAX_ARGS; ++i) {
+        len += varint_put(&payload[len], zigzag_encode(p_log->args[i]));
+    }
+    return stream_frame_encode(STREAM_FRAME_LOG, frame_seq, payload, len, p_out);
+}
+
+bool stream_log_decode(const stream_frame_t * p_frame, stream_log_t * p_log)
+{
+    uint16_t index = 0;
+    if (p_frame->type != STREAM_FRAME_LOG ||
+        !varint_get(p_frame->p_payload, p_frame->len, &index, &p_log->token))
+    {
+        return false;
+    }
+    p_log->count = 0;
+    while (index < p_frame->len) {
+        uint32_t value;
+        if (p_log->count == STREAM_LOG_MAX_ARGS ||
+            !varint_get(p_frame->p_payload, p_frame->len, &index, &value))
+        {
+            return false;
+        }
+        p_log->args[p_log->count++] = zigzag_decode(value);
+    }
+    return true;
+}
+
+// Stats --------------------------------------------------------------------------------------------
+
+uint16_t stream_stats_encode(uint8_t first_index, const uint32_t * p_values, uint8_t count,
+                             uint8_t frame_seq, uint8_t * p_out, uint8_t * p_encoded)
+{
+    uint8_t payload[STREAM_FRAME_MAX_PAYLOAD];
+    uint16_t len = 0;
+    uint8_t encoded = 0;
+    payload[len++] = first_index;
+    while (encoded < count && len + varint_len(p_values[encoded]) <= sizeof(payload)) {
+        len += varint_put(&payload[len], p_values[encoded++]);
+    }
+    *p_encoded = encoded;
+    return stream_frame_encode(STREAM_FRAME_STATS, frame_seq, payload, len, p_out);
+}
+
+bool stream_stats_decode(const stream_frame_t * p_frame, uint8_t * p_first_index,
+                         uint32_t * p_values, uint8_t max_count, uint8_t * p_count)
+{
+    uint16_t index = 1;
+    uint8_t count = 0;
+    if (p_frame->type != STREAM_FRAME_STATS || p_frame->len < index) {
+        return false;
+    }
+    while (index < p_frame->len) {
+        if (count == max_count || !varint_get(p_frame->p_payload, p_frame->len, &index, &p_values[count])) {
+            return false;
+        }
+        ++count;
+    }
+    *p_first_index = p_frame->p_payload[0];
+    *p_count = count;
+    return true;
+}
+
+// Encoder ------------------------------------------------------------------------------------------
+
+static inline uint8_t run_record_len(uint16_t run)
+{
+    if (run == 0) {
+        return 0;
+    }
+    return (run <= RECORD_INLINE_MAX) ? 1 : 1 + varint_len(run);
+}
+
+/**@brief Bytes held back for runs that have not been written yet. */
+static uint8_t pending_run_bytes(const stream_encoder_t * p_enc)
+{
+    uint8_t total = 0;
+    for (uint8_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        total += run_record_len(p_enc->channels[stream].run);
+    }
+    return total;
+}
+
+static void run_flush(stream_encoder_t * p_enc, stream_id_t stream)
+{
+    uint16_t run = p_enc->channels[stream].run;
+    if (run == 0) {
+        return;
+    }
+    if (run <= RECORD_INLINE_MAX) {
+        p_enc->payload[p_enc->len++] = record_header(stream, STREAM_RECORD_RUN, run);
+    }
+    else {
+        p_enc->payload[p_enc->len++] = record_header(stream, STREAM_RECORD_RUN, 0);
+        p_enc->len += varint_put(&p_enc->payload[p_enc->len], run);
+    }
+    p_enc->channels[stream].run = 0;
+}
+
+static void encoder_reset_frame(stream_encoder_t * p_enc)
+{
+    p_enc->len = 0;
+    p_enc->samples = 0;
+    memset(p_enc->channels, 0, sizeof(p_enc->channels));
+}
+
+void stream_encoder_init(stream_encoder_t * p_enc)
+{
+    encoder_reset_frame(p_enc);
+    p_enc->frame_seq = 0;
+    p_enc->urgent_seq = 0;
+}
+
+bool stream_encoder_put(stream_encoder_t * p_enc, stream_id_t stream, uint64_t ticks,
+                        uint16_t seq, const int32_t * p_values)
+{
+    // Samples of unknown streams are dropped rather than corrupting the frame
+    if (stream >= STREAM_COUNT) {
+        return true;
+    }
+    stream_channel_t * p_channel = &p_enc->channels[stream];
+    const uint8_t count = m_value_counts[stream];
+    uint8_t reserved = pending_run_bytes(p_enc);
+
+    if (p_enc->samples == 0) {
+        p_enc->base_ticks = ticks;
+        reserved += varint64_len(ticks);
+    }
+    if (!p_channel->primed) {
+        p_channel->last_ticks = p_enc->base_ticks;
+    }
+    // Samples are at most a frame apart, so the interval always fits 32 bits
+    const int32_t interval = (int32_t)(ticks - p_channel->last_ticks);
+    const int32_t jitter = (int32_t)((uint32_t)interval - (uint32_t)p_channel->last_interval);
+
+    // The stream's first sample in the frame states its number, later ones only a jump
+    const uint16_t skip = (uint16_t)(seq - p_channel->next_seq);
+    uint8_t seq_len = 0;
+    if (!p_channel->primed) {
+        seq_len = RECORD_SEQ_LEN;
+    }
+    else if (skip != 0) {
+        seq_len = (skip <= RECORD_INLINE_MAX) ? 1 : RECORD_SEQ_LEN;
+    }
+
+    if (p_channel->primed && jitter == 0 && seq_len == 0 &&
+        memcmp(p_channel->last, p_values, count * sizeof(int32_t)) == 0 &&
+        p_channel->run < UINT16_MAX)
+    {
+        uint8_t growth = run_record_len(p_channel->run + 1) - run_record_len(p_channel->run);
+        if (p_enc->len + reserved + growth > STREAM_FRAME_MAX_PAYLOAD) {
+            return false;
+        }
+        ++p_channel->run;
+        ++p_enc->samples;
+        p_channel->last_ticks = ticks;
+        p_channel->next_seq = seq + 1;
+        return true;
+    }
+
+    uint32_t deltas[STREAM_MAX_VALUES];
+    const uint32_t time_delta = zigzag_encode(jitter);
+    uint8_t record_len = seq_len + 1 + varint_len(time_delta);
+    for (uint8_t i = 0; i < count; ++i) {
+        // Wrapping subtraction: the decoder adds the delta back with the same wrap
+        deltas[i] = zigzag_encode((int32_t)((uint32_t)p_values[i] - (uint32_t)p_channel->last[i]));
+        record_len += varint_len(deltas[i]);
+    }
+    if (p_enc->len + reserved + record_len > STREAM_FRAME_MAX_PAYLOAD) {
+        return false;
+    }
+
+    if (p_enc->samples == 0) {
+        p_enc->len += varint64_put(&p_enc->payload[p_enc->len], ticks);
+    }
+    run_flush(p_enc, stream);
+    if (seq_len == 1) {
+        p_enc->payload[p_enc->len++] = record_header(stream, STREAM_RECORD_SEQ, skip);
+    }
+    else if (seq_len > 1) {
+        p_enc->payload[p_enc->len++] = record_header(stream, STREAM_RECORD_SEQ, 0);
+        p_enc->payload[p_enc->len++] = (uint8_t)seq;
+        p_enc->payload[p_enc->len++] = (uint8_t)(seq >> 8);
+    }
+    p_enc->payload[p_enc->len++] = record_header(stream, STREAM_RECORD_SAMPLE, 0);
+    p_enc->len += varint_put(&p_enc->payload[p_enc->len], time_delta);
+    for (uint8_t i = 0; i < count; ++i) {
+        p_enc->len += varint_put(&p_enc->payload[p_enc->len], deltas[i]);
+        p_channel->last[i] = p_values[i];
+    }
+    p_channel->last_ticks = ticks;
+    p_channel->last_interval = interval;
+    p_channel->next_seq = seq + 1;
+    p_channel->primed = true;
+    ++p_enc->samples;
+    return true;
+}
+
+bool stream_encoder_full(const stream_encoder_t * p_enc)
+{
+    return p_enc->samples >= STREAM_FRAME_MAX_SAMPLES;
+}
+
+bool stream_encoder_empty(const stream_encoder_t * p_enc)
+{
+    return p_enc->samples == 0;
+}
+
+uint16_t stream_encoder_finish(stream_encoder_t * p_enc, uint8_t * p_out)
+{
+    if (p_enc->samples == 0) {
+        return 0;
+    }
+    for (uint8_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        run_flush(p_enc, stream);
+    }
+    uint16_t written = stream_frame_encode(STREAM_FRAME_SAMPLES, p_enc->frame_seq++,
+                                           p_enc->payload, p_enc->len, p_out);
+    encoder_reset_frame(p_enc);
+    return written;
+}
+
+// Decoder ------------------------------------------------------------------------------------------
+
+bool stream_samples_decode(const stream_frame_t * p_frame,
+                           stream_sample_handler_t handler, void * p_context)
+{
+    stream_channel_t channels[STREAM_COUNT] = {0};
+    const uint8_t * p_data = p_frame->p_payload;
+    uint16_t index = 0;
+    uint64_t base_ticks;
+
+    if (p_frame->type != STREAM_FRAME_SAMPLES ||
+        !varint64_get(p_data, p_frame->len, &index, &base_ticks))
+    {
+        return false;
+    }
+    for (uint8_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        channels[stream].last_ticks = base_ticks;
+    }
+
+    while (index < p_frame->len) {
+        uint8_t header = p_data[index++];
+        uint8_t stream = header & RECORD_STREAM_MASK;
+        uint8_t kind = (header >> RECORD_KIND_SHIFT) & RECORD_KIND_MASK;
+        uint8_t inline_arg = header >> RECORD_INLINE_SHIFT;
+        if (stream >= STREAM_COUNT) {
+            return false;
+        }
+        stream_channel_t * p_channel = &channels[stream];
+        uint8_t count = m_value_counts[stream];
+
+        switch (kind) {
+        case STREAM_RECORD_SAMPLE:
+            uint32_t jitter;
+            if (!varint_get(p_data, p_frame->len, &index, &jitter)) {
+                return false;
+            }
+            p_channel->last_interval = (int32_t)((uint32_t)p_channel->last_interval +
+                                                 (uint32_t)zigzag_decode(jitter));
+            p_channel->last_ticks += (int64_t)p_channel->last_interval;
+            for (uint8_t i = 0; i < count; ++i) {
+                uint32_t delta;
+                if (!varint_get(p_data, p_frame->len, &index, &delta)) {
+                    return false;
+                }
+                p_channel->last[i] = (int32_t)((uint32_t)p_channel->last[i] + (uint32_t)zigzag_decode(delta));
+            }
+            p_channel->primed = true;
+            handler(p_context, stream, p_channel->last_ticks, p_channel->next_seq++, p_channel->last, count);
+            break;
+        case STREAM_RECORD_RUN:
+            uint32_t run = inline_arg;
+            if (run == 0 && !varint_get(p_data, p_frame->len, &index, &run)) {
+                return false;
+            }
+            if (!p_channel->primed || run > UINT16_MAX) {
+                return false;
+            }
+            while (run--) {
+                p_channel->last_ticks += (int64_t)p_channel->last_interval;
+                handler(p_context, stream, p_channel->last_ticks, p_channel->next_seq++, p_channel->last, count);
+            }
+            break;
+        case STREAM_RECORD_SEQ:
+            if (inline_arg != 0) {
+                p_channel->next_seq += inline_arg;
+                break;
+            }
+            if (index + 2 > p_frame->len) {
+                return false;
+            }
+            p_channel->next_seq = p_data[index] | (p_data[index + 1] << 8);
+            index += 2;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,298 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef STREAM_CODEC_H
+#define STREAM_CODEC_H
+
+/**@file
+ *
+ * @brief    Compressed binary encoding of the sensor stream.
+ *
+ * @details  Samples are collected into frames. Within a frame each stream (one per SensorTag
+ *           service) is delta encoded against its previous sample, the deltas are written as
+ *           zigzag varints, and consecutive identical samples are collapsed into a run.
+ *           The first sample of every stream in a frame is written as a delta from zero, so
+ *           each frame decodes on its own and a lost frame loses only its own samples.
+ *
+ *           Every sample keeps its receive timestamp. A samples payload starts with the frame's
+ *           base time (RTC ticks, varint), and each sample record carries the change in its
+ *           stream's sampling interval (zigzag varint), which is 0 for a steady stream. A run
+ *           covers samples that repeat both the values and the interval exactly.
+ *
+ *           Every sample also keeps the sequence number its notification was given on receipt
+ *           (16 bits, per stream, wrapping). Numbers are implicit while they are consecutive:
+ *           a sequence record gives the number of each stream's first sample in a frame, and
+ *           any jump after it, which is where the gateway withheld samples (a dead-band rule,
+ *           a payload that did not decode). Samples lost on the way show as a jump across a
+ *           frame_seq gap instead.
+ *
+ *           On the wire a frame is:
+ *
+ *               0x00 | COBS( type | frame_seq | payload | crc16 ) | 0x00
+ *
+ *           COBS guarantees that 0x00 never appears inside a frame, so a decoder that has
+ *           dropped bytes simply discards input up to the next 0x00 and carries on. The
+ *           CRC (CCITT, as crc16_compute in the Nordic SDK) rejects damaged frames, and the
+ *           8-bit frame_seq shows the decoder how many frames were lost in between. Alert and
+ *           log frames are numbered in a sequence of their own, because the gateway sends them
+ *           ahead of frames it has already queued.
+ *
+ * @note     This module has no SDK dependencies; the Linux tools in host/ build the same source.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STREAM_FRAME_DELIMITER      0x00
+
+#define STREAM_FRAME_MAX_PAYLOAD    48                          /**< Payload bytes carried by one frame. */
+#define STREAM_FRAME_MAX_SAMPLES    16                          /**< Samples per frame before it is closed. */
+#define STREAM_FRAME_HEADER_LEN     2                           /**< type + frame_seq */
+#define STREAM_FRAME_CRC_LEN        2
+#define STREAM_FRAME_MAX_BODY       (STREAM_FRAME_HEADER_LEN + STREAM_FRAME_MAX_PAYLOAD + STREAM_FRAME_CRC_LEN)
+/**< Worst-case bytes on the wire for one frame: body, one COBS overhead byte, two delimiters. */
+#define STREAM_FRAME_MAX_ENCODED    (STREAM_FRAME_MAX_BODY + 1 + 2)
+
+#define STREAM_MAX_VALUES           2                           /**< Most values carried by one sample. */
+#define STREAM_VARINT_MAX_LEN       5                           /**< Bytes needed for a 32 bit varint. */
+#define STREAM_VARINT64_MAX_LEN     10                          /**< Bytes needed for a 64 bit varint. */
+#define STREAM_LOG_MAX_ARGS         6                           /**< Most arguments carried by a log frame. */
+
+/**@brief Frame types carried in the first byte of each frame body. */
+typedef enum
+{
+    STREAM_FRAME_SAMPLES = 0x01,            // Delta/run-length encoded sample records
+    STREAM_FRAME_ALERT   = 0x02,            // One stream_alert_t, sent as soon as it is raised
+    STREAM_FRAME_STATS   = 0x03,            // Runtime counters: index of the first, then one varint each
+    STREAM_FRAME_LOG     = 0x04,            // Tokenized diagnostic: token varint, then one zigzag varint per argument
+} stream_frame_type_t;
+
+/**@brief Independent frame_seq sequences. */
+typedef enum
+{
+    STREAM_SEQ_FRAMES = 0,                  // Samples and stats frames, in the order they were built
+    STREAM_SEQ_URGENT,                      // Alert and log frames, which may overtake the others
+    STREAM_SEQ_COUNT
+} stream_seq_space_t;
+
+/**@brief Stream identifiers, one per SensorTag service. Fits the 3 bit record field. */
+typedef enum
+{
+    STREAM_LUXO = 0,                        // Luxometer: 1 value, raw sensor word
+    STREAM_TEMP,                            // Temperature: 2 values, IR and ambient in 1/128 C
+    STREAM_COUNT
+} stream_id_t;
+
+/**@brief Record kinds, bits [4:3] of a record header. */
+typedef enum
+{
+    STREAM_RECORD_SAMPLE = 0,               // Followed by interval change, then one value delta per value
+    STREAM_RECORD_RUN,                      // Previous sample and interval repeated; count inline or varint
+    STREAM_RECORD_SEQ,                      // Sequence numbers skipped inline, or 0 and the next number, 16 bit LE
+} stream_record_kind_t;
+
+/**@brief Per-stream encoder state, reset at the start of every frame. */
+typedef struct
+{
+    int32_t             last[STREAM_MAX_VALUES];
+    uint64_t            last_ticks;
+    int32_t             last_interval;
+    uint16_t            run;
+    uint16_t            next_seq;
+    bool                primed;
+} stream_channel_t;
+
+/**@brief Encoder for STREAM_FRAME_SAMPLES frames. */
+typedef struct
+{
+    uint8_t             payload[STREAM_FRAME_MAX_PAYLOAD];
+    uint8_t             len;
+    uint8_t             samples;
+    uint8_t             frame_seq;
+    uint8_t             urgent_seq;                             // frame_seq of the next alert or log frame
+    uint64_t            base_ticks;
+    stream_channel_t    channels[STREAM_COUNT];
+} stream_encoder_t;
+
+/**@brief Contents of a STREAM_FRAME_ALERT frame.
+ *
+ * @details Payload: rule_index, stream, value_index, rule kind, raised (one byte each),
+ *          then the value as a zigzag varint.
+ */
+typedef struct
+{
+    uint8_t             rule_index;
+    uint8_t             stream;
+    uint8_t             value_index;
+    uint8_t             kind;
+    bool                raised;
+    int32_t             value;
+} stream_alert_t;
+
+/**@brief Contents of a STREAM_FRAME_LOG frame.
+ *
+ * @details The token identifies the format string in the firmware's log dictionary (see
+ *          log_support.h); the arguments are the printf arguments, as 32 bit words.
+ */
+typedef struct
+{
+    uint32_t            token;
+    uint8_t             count;
+    int32_t             args[STREAM_LOG_MAX_ARGS];
+} stream_log_t;
+
+/**@brief A frame after COBS decoding and CRC check; p_payload points into the caller's buffer. */
+typedef struct
+{
+    uint8_t             type;
+    uint8_t             frame_seq;
+    const uint8_t       *p_payload;
+    uint16_t            len;
+} stream_frame_t;
+
+/**@brief   Callback for each sample recovered by stream_samples_decode. */
+typedef void (* stream_sample_handler_t)(void * p_context, stream_id_t stream, uint64_t ticks,
+                                         uint16_t seq, const int32_t * p_values, uint8_t count);
+
+
+/**@brief   Number of values carried by a sample of the given stream. */
+uint8_t stream_value_count(stream_id_t stream);
+
+/**@brief   Reset an encoder, including its frame sequence counters. */
+void stream_encoder_init(stream_encoder_t * p_enc);
+
+/**@brief   Add a sample to the frame under construction.
+ *
+ * @param[in] p_enc     Encoder
+ * @param[in] stream    Stream the sample belongs to
+ * @param[in] ticks     Receive time of the sample
+ * @param[in] seq       Sequence number of the sample in its stream
+ * @param[in] p_values  stream_value_count(stream) values
+ *
+ * @retval    true if the sample was added, false if the frame is full and must be finished first.
+ */
+bool stream_encoder_put(stream_encoder_t * p_enc, stream_id_t stream, uint64_t ticks,
+                        uint16_t seq, const int32_t * p_values);
+
+/**@brief   True when the frame has reached STREAM_FRAME_MAX_SAMPLES and should be finished. */
+bool stream_encoder_full(const stream_encoder_t * p_enc);
+
+/**@brief   True when the frame under construction holds no samples. */
+bool stream_encoder_empty(const stream_encoder_t * p_enc);
+
+/**@brief   Close the current frame, write it to p_out and start a new one.
+ *
+ * @param[in]  p_enc     Encoder
+ * @param[out] p_out     Output buffer, at least STREAM_FRAME_MAX_ENCODED bytes
+ *
+ * @return  Number of bytes written, 0 if the frame was empty.
+ */
+uint16_t stream_encoder_finish(stream_encoder_t * p_enc, uint8_t * p_out);
+
+/**@brief   Frame an arbitrary payload: header, CRC, COBS and delimiters.
+ *
+ * @param[in]  type      Frame type
+ * @param[in]  frame_seq Frame sequence number
+ * @param[in]  p_payload Payload, at most STREAM_FRAME_MAX_PAYLOAD bytes
+ * @param[in]  len       Payload length
+ * @param[out] p_out     Output buffer, at least STREAM_FRAME_MAX_ENCODED bytes
+ *
+ * @return  Number of bytes written, 0 if the payload is too long.
+ */
+uint16_t stream_frame_encode(uint8_t type, uint8_t frame_seq,
+                             const uint8_t * p_payload, uint16_t len, uint8_t * p_out);
+
+/**@brief   Decode one frame in place.
+ *
+ * @details p_buf holds the bytes between two delimiters, exclusive. It is COBS decoded in
+ *          place and the CRC is checked; on success p_frame points into p_buf.
+ *
+ * @retval  true if the frame is intact.
+ */
+bool stream_frame_decode(uint8_t * p_buf, uint16_t len, stream_frame_t * p_frame);
+
+/**@brief   The frame_seq sequence a frame type is numbered in. */
+stream_seq_space_t stream_frame_seq_space(uint8_t type);
+
+/**@brief   Walk the records of a STREAM_FRAME_SAMPLES payload.
+ *
+ * @retval  true if the payload was well formed to the end.
+ */
+bool stream_samples_decode(const stream_frame_t * p_frame,
+                           stream_sample_handler_t handler, void * p_context);
+
+/**@brief   Encode an alert as a complete STREAM_FRAME_ALERT frame.
+ *
+ * @param[in]  p_alert   Alert
+ * @param[in]  frame_seq Frame sequence number
+ * @param[out] p_out     Output buffer, at least STREAM_FRAME_MAX_ENCODED bytes
+ *
+ * @return  Number of bytes written.
+ */
+uint16_t stream_alert_encode(const stream_alert_t * p_alert, uint8_t frame_seq, uint8_t * p_out);
+
+/**@brief   Read the alert from a decoded STREAM_FRAME_ALERT frame.
+ *
+ * @retval  true if the frame held a well formed alert.
+ */
+bool stream_alert_decode(const stream_frame_t * p_frame, stream_alert_t * p_alert);
+
+/**@brief   Encode a log message as a complete STREAM_FRAME_LOG frame.
+ *
+ * @param[in]  p_log     Message, at most STREAM_LOG_MAX_ARGS arguments
+ * @param[in]  frame_seq Frame sequence number
+ * @param[out] p_out     Output buffer, at least STREAM_FRAME_MAX_ENCODED bytes
+ *
+ * @return  Number of bytes written.
+ */
+uint16_t stream_log_encode(const stream_log_t * p_log, uint8_t frame_seq, uint8_t * p_out);
+
+/**@brief   Read the message from a decoded STREAM_FRAME_LOG frame.
+ *
+ * @retval  true if the frame held a well formed message.
+ */
+bool stream_log_decode(const stream_frame_t * p_frame, stream_log_t * p_log);
+
+/**@brief   Encode as many counters as fit into one STREAM_FRAME_STATS frame.
+ *
+ * @param[in]  first_index Index of p_values[0] in the sender's counter table
+ * @param[in]  p_values    Counters
+ * @param[in]  count       Number of counters in p_values
+ * @param[in]  frame_seq   Frame sequence number
+ * @param[out] p_out       Output buffer, at least STREAM_FRAME_MAX_ENCODED bytes
+ * @param[out] p_encoded   Number of counters that were encoded; send the rest in another frame
+ *
+ * @return  Number of bytes written.
+ */
+uint16_t stream_stats_encode(uint8_t first_index, const uint32_t * p_values, uint8_t count,
+                             uint8_t frame_seq, uint8_t * p_out, uint8_t * p_encoded);
+
+/**@brief   Read the counters from a decoded STREAM_FRAME_STATS frame.
+ *
+ * @param[in]  p_frame       Frame
+ * @param[out] p_first_index Index of the first counter in the sender's table
+ * @param[out] p_values      Counters
+ * @param[in]  max_count     Capacity of p_values
+ * @param[out] p_count       Number of counters read
+ *
+ * @retval  true if the frame held well formed counters.
+ */
+bool stream_stats_decode(const stream_frame_t * p_frame, uint8_t * p_first_index,
+                         uint32_t * p_values, uint8_t max_count, uint8_t * p_count);
+
+/**@brief   CRC-16/CCITT (init 0xFFFF), matching crc16_compute from the Nordic SDK. */
+uint16_t stream_crc16(const uint8_t * p_data, uint16_t len, uint16_t crc);
+
+#endif // STREAM_CODEC_H
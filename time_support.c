@@ -0,0 +1,70 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+
+#include "time_support.h"
+#include "lifecycle_support.h"
+
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+
+#define RTC_COUNTER_BITS        24
+#define RTC_COUNTER_MASK        ((1UL << RTC_COUNTER_BITS) - 1)
+#define WRAP_CHECK_INTERVAL_MS  (128UL * 1000)                   /**< A quarter of the RTC1 wrap period. */
+
+APP_TIMER_DEF(m_wrap_timer);
+
+static uint32_t m_wraps;
+static uint32_t m_last_counter;
+
+
+uint64_t time_support_now(void)
+{
+    uint32_t counter;
+    uint64_t ticks;
+
+    CRITICAL_REGION_ENTER();
+    UNUSED_VARIABLE(app_timer_cnt_get(&counter));
+    counter &= RTC_COUNTER_MASK;
+    if (counter < m_last_counter) {
+        ++m_wraps;
+    }
+    m_last_counter = counter;
+    ticks = ((uint64_t)m_wraps << RTC_COUNTER_BITS) | counter;
+    CRITICAL_REGION_EXIT();
+
+    return ticks;
+}
+
+static void wrap_timeout_handler(void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    UNUSED_VARIABLE(time_support_now());
+}
+
+void time_support_init(void)
+{
+    uint32_t err_code;
+
+    err_code = app_timer_create(&m_wrap_timer, APP_TIMER_MODE_REPEATED, wrap_timeout_handler);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_start(m_wrap_timer,
+                               APP_TIMER_TICKS(WRAP_CHECK_INTERVAL_MS, APP_TIMER_PRESCALER),
+                               NULL);
+    APP_ERROR_CHECK(err_code);
+}
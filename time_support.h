@@ -0,0 +1,40 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef TIME_SUPPORT_H
+#define TIME_SUPPORT_H
+
+/**@file
+ *
+ * @brief    64 bit timestamps from RTC1.
+ *
+ * @details  RTC1 is owned by app_timer and runs at 32768 Hz (APP_TIMER_PRESCALER 0). Its
+ *           24 bit counter wraps every 512 s; this module extends it to 64 bits by counting
+ *           the wraps in software. A repeating app_timer reads the counter four times per wrap
+ *           period so that no wrap is ever missed, even when no samples arrive.
+ */
+
+#include <stdint.h>
+
+#define TIME_TICKS_PER_SECOND   32768
+
+
+/**@brief   Start the wrap tracking timer. Call after timer_init(). */
+void time_support_init(void);
+
+/**@brief   Ticks since boot, at TIME_TICKS_PER_SECOND. */
+uint64_t time_support_now(void);
+
+#endif // TIME_SUPPORT_H
@@ -0,0 +1,427 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "uart_support.h"
+#include "stats_support.h"
+
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "boards.h"
+
+static uart_rx_handler_t m_rx_handler;
+
+#if defined(NRF52)
+
+// UARTE with EasyDMA ------------------------------------------------------------------------------
+
+#include "nrf_drv_common.h"
+#include "nrf_gpio.h"
+
+#define UART_TX_BLOCK_SIZE      256                             /**< Bytes per DMA block of the bulk lane; two blocks are used. */
+#define UART_TX_URGENT_SIZE     128                             /**< Bytes per DMA block of the urgent lane; two blocks are used. */
+
+#if   UART_BAUD == 1000000
+#define UART_BAUD_REGISTER      UARTE_BAUDRATE_BAUDRATE_Baud1M
+#elif UART_BAUD == 921600
+#define UART_BAUD_REGISTER      UARTE_BAUDRATE_BAUDRATE_Baud921600
+#elif UART_BAUD == 460800
+#define UART_BAUD_REGISTER      UARTE_BAUDRATE_BAUDRATE_Baud460800
+#elif UART_BAUD == 230400
+#define UART_BAUD_REGISTER      UARTE_BAUDRATE_BAUDRATE_Baud230400
+#elif UART_BAUD == 115200
+#define UART_BAUD_REGISTER      UARTE_BAUDRATE_BAUDRATE_Baud115200
+#else
+#error "Unsupported UART_BAUD"
+#endif
+
+/**@brief A pair of DMA blocks: one is filled while the other may be being sent. */
+typedef struct
+{
+    uint8_t             *p_blocks[2];
+    uint16_t            block_size;
+    uint16_t            fill_len;                               // Bytes waiting in the block being filled
+    uint8_t             fill;                                   // Index of the block being filled
+    uint8_t             peak;                                   // Highest fill of the block, percent, see uart_peak
+    uint32_t            dropped;                                // Bytes dropped, see uart_dropped
+} uart_tx_lane_t;
+
+static uint8_t          m_tx_urgent_blocks[2][UART_TX_URGENT_SIZE];
+static uint8_t          m_tx_bulk_blocks[2][UART_TX_BLOCK_SIZE];
+
+static uart_tx_lane_t   m_tx_lanes[UART_LANE_COUNT] =
+{
+    [UART_LANE_URGENT] = { { m_tx_urgent_blocks[0], m_tx_urgent_blocks[1] }, UART_TX_URGENT_SIZE },
+    [UART_LANE_BULK]   = { { m_tx_bulk_blocks[0],   m_tx_bulk_blocks[1]   }, UART_TX_BLOCK_SIZE  },
+};
+static bool             m_tx_busy;                              // A block is being sent
+
+static uint8_t          m_rx_bytes[2];
+static uint8_t          m_rx_index;                             // Buffer the transfer in progress writes to
+
+/**@brief Hand a lane's filled block to the DMA and start filling its other one. */
+static void uart_tx_start(uart_tx_lane_t * p_lane)
+{
+    NRF_UARTE0->TXD.PTR    = (uint32_t)p_lane->p_blocks[p_lane->fill];
+    NRF_UARTE0->TXD.MAXCNT = p_lane->fill_len;
+    NRF_UARTE0->TASKS_STARTTX = 1;
+
+    m_tx_busy = true;
+    p_lane->fill ^= 1;
+    p_lane->fill_len = 0;
+}
+
+/**@brief Send the next filled block, the urgent lane's first. */
+static void uart_tx_next(void)
+{
+    for (uint8_t lane = 0; lane < UART_LANE_COUNT; ++lane) {
+        if (m_tx_lanes[lane].fill_len > 0) {
+            uart_tx_start(&m_tx_lanes[lane]);
+            return;
+        }
+    }
+}
+
+void UARTE0_UART0_IRQHandler(void)
+{
+    if (NRF_UARTE0->EVENTS_ENDTX) {
+        NRF_UARTE0->EVENTS_ENDTX = 0;
+        m_tx_busy = false;
+        uart_tx_next();
+    }
+
+    // ENDRX is handled before RXSTARTED: the shortcut has already restarted reception into
+    // the other buffer, whose pointer RXSTARTED then moves on again
+    if (NRF_UARTE0->EVENTS_ENDRX) {
+        NRF_UARTE0->EVENTS_ENDRX = 0;
+        uint8_t byte = m_rx_bytes[m_rx_index];
+        m_rx_index ^= 1;
+        if (NRF_UARTE0->RXD.AMOUNT > 0 && m_rx_handler != NULL) {
+            m_rx_handler(byte);
+        }
+    }
+
+    if (NRF_UARTE0->EVENTS_RXSTARTED) {
+        NRF_UARTE0->EVENTS_RXSTARTED = 0;
+        NRF_UARTE0->RXD.PTR = (uint32_t)&m_rx_bytes[m_rx_index ^ 1];
+    }
+
+    // Framing and overrun errors lose the byte only; reception carries on
+    if (NRF_UARTE0->EVENTS_ERROR) {
+        NRF_UARTE0->EVENTS_ERROR = 0;
+        NRF_UARTE0->ERRORSRC = NRF_UARTE0->ERRORSRC;
+        stats_increment(STATS_UART_RX_ERRORS);
+    }
+}
+
+void uart_init(uart_rx_handler_t rx_handler)
+{
+    m_rx_handler = rx_handler;
+
+    nrf_gpio_pin_set(TX_PIN_NUMBER);
+    nrf_gpio_cfg_output(TX_PIN_NUMBER);
+    nrf_gpio_cfg_input(RX_PIN_NUMBER, NRF_GPIO_PIN_NOPULL);
+
+    NRF_UARTE0->PSEL.TXD = TX_PIN_NUMBER;
+    NRF_UARTE0->PSEL.RXD = RX_PIN_NUMBER;
+    NRF_UARTE0->PSEL.RTS = RTS_PIN_NUMBER;
+    NRF_UARTE0->PSEL.CTS = CTS_PIN_NUMBER;
+    NRF_UARTE0->BAUDRATE = UART_BAUD_REGISTER;
+    NRF_UARTE0->CONFIG   = UARTE_CONFIG_HWFC_Enabled << UARTE_CONFIG_HWFC_Pos;
+
+    NRF_UARTE0->SHORTS   = UARTE_SHORTS_ENDRX_STARTRX_Msk;
+    NRF_UARTE0->INTENSET = UARTE_INTENSET_ENDTX_Msk | UARTE_INTENSET_ENDRX_Msk |
+                           UARTE_INTENSET_RXSTARTED_Msk | UARTE_INTENSET_ERROR_Msk;
+    NRF_UARTE0->ENABLE   = UARTE_ENABLE_ENABLE_Enabled;
+
+    NRF_UARTE0->RXD.PTR    = (uint32_t)&m_rx_bytes[0];
+    NRF_UARTE0->RXD.MAXCNT = 1;
+    NRF_UARTE0->TASKS_STARTRX = 1;
+
+    // The lowest application priority, shared with the BLE and app_timer events, so that the
+    // output path is never re-entered from those handlers
+    nrf_drv_common_irq_enable(UARTE0_UART0_IRQn, APP_IRQ_PRIORITY_LOWEST);
+}
+
+uint16_t uart_write(uart_lane_t lane, const uint8_t * p_data, uint16_t len)
+{
+    uart_tx_lane_t * p_lane = &m_tx_lanes[lane];
+    uint16_t written = 0;
+
+    // printf may also run in thread mode, below the UARTE interrupt
+    CRITICAL_REGION_ENTER();
+    // A block boundary is where the other lane may cut in, so a write that fits in one block
+    // is never split across two
+    if (len > p_lane->block_size || len <= p_lane->block_size - p_lane->fill_len) {
+        while (written < len) {
+            uint16_t chunk = MIN(len - written, p_lane->block_size - p_lane->fill_len);
+            if (chunk == 0) {
+                break;
+            }
+            memcpy(&p_lane->p_blocks[p_lane->fill][p_lane->fill_len], &p_data[written], chunk);
+            p_lane->fill_len += chunk;
+            written += chunk;
+            if (!m_tx_busy) {
+                uart_tx_start(p_lane);
+            }
+        }
+    }
+    p_lane->peak = MAX(p_lane->peak, p_lane->fill_len * 100 / p_lane->block_size);
+    p_lane->dropped += len - written;
+    CRITICAL_REGION_EXIT();
+
+    if (written < len) {
+        stats_add(STATS_UART_DROPPED, len - written);
+    }
+    return written;
+}
+
+uint16_t uart_free(uart_lane_t lane)
+{
+    uint16_t free;
+
+    CRITICAL_REGION_ENTER();
+    free = m_tx_lanes[lane].block_size - m_tx_lanes[lane].fill_len;
+    CRITICAL_REGION_EXIT();
+    return free;
+}
+
+#else
+
+// app_uart_fifo ---------------------------------------------------------------------------------
+
+#include "app_uart.h"
+
+#define UART_TX_BUF_SIZE        16                              /**< app_uart TX FIFO size; bytes in it are no longer reordered. */
+#define UART_RX_BUF_SIZE        256                             /**< UART RX buffer size. */
+#define UART_TX_URGENT_SIZE     128                             /**< Urgent lane size, a power of two. */
+#define UART_TX_BULK_SIZE       256                             /**< Bulk lane size, a power of two. */
+
+#if   UART_BAUD == 1000000
+#define UART_BAUD_REGISTER      UART_BAUDRATE_BAUDRATE_Baud1M
+#elif UART_BAUD == 921600
+#define UART_BAUD_REGISTER      UART_BAUDRATE_BAUDRATE_Baud921600
+#elif UART_BAUD == 460800
+#define UART_BAUD_REGISTER      UART_BAUDRATE_BAUDRATE_Baud460800
+#elif UART_BAUD == 230400
+#define UART_BAUD_REGISTER      UART_BAUDRATE_BAUDRATE_Baud230400
+#elif UART_BAUD == 115200
+#define UART_BAUD_REGISTER      UART_BAUDRATE_BAUDRATE_Baud115200
+#else
+#error "Unsupported UART_BAUD"
+#endif
+
+/**@brief A lane: a ring of queued bytes, indices free running. */
+typedef struct
+{
+    uint8_t             *p_buf;
+    uint16_t            size;
+    uint16_t            read;
+    uint16_t            write;
+    uint8_t             peak;                                   // Highest fill, percent, see uart_peak
+    uint32_t            dropped;                                // Bytes dropped, see uart_dropped
+} uart_tx_lane_t;
+
+static uint8_t          m_tx_urgent_buf[UART_TX_URGENT_SIZE];
+static uint8_t          m_tx_bulk_buf[UART_TX_BULK_SIZE];
+
+static uart_tx_lane_t   m_tx_lanes[UART_LANE_COUNT] =
+{
+    [UART_LANE_URGENT] = { m_tx_urgent_buf, UART_TX_URGENT_SIZE },
+    [UART_LANE_BULK]   = { m_tx_bulk_buf,   UART_TX_BULK_SIZE   },
+};
+
+// Each bulk write is queued behind a one byte length, so that the urgent lane only cuts in
+// between bulk writes
+static uint8_t          m_tx_bulk_left;                         // Bytes of the bulk write being moved to the FIFO
+
+static uint16_t uart_tx_used(const uart_tx_lane_t * p_lane)
+{
+    return (uint16_t)(p_lane->write - p_lane->read);
+}
+
+static uint8_t uart_tx_get(uart_tx_lane_t * p_lane)
+{
+    return p_lane->p_buf[p_lane->read++ & (p_lane->size - 1)];
+}
+
+static void uart_tx_put(uart_tx_lane_t * p_lane, const uint8_t * p_data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; ++i) {
+        p_lane->p_buf[p_lane->write++ & (p_lane->size - 1)] = p_data[i];
+    }
+}
+
+/**@brief Move queued bytes into the app_uart FIFO until it is full, the urgent lane's first. */
+static void uart_tx_pump(void)
+{
+    uart_tx_lane_t * p_urgent = &m_tx_lanes[UART_LANE_URGENT];
+    uart_tx_lane_t * p_bulk   = &m_tx_lanes[UART_LANE_BULK];
+
+    for (;;) {
+        uart_tx_lane_t * p_lane;
+        if (m_tx_bulk_left == 0 && uart_tx_used(p_urgent) > 0) {
+            p_lane = p_urgent;
+        }
+        else if (m_tx_bulk_left > 0) {
+            p_lane = p_bulk;
+        }
+        else if (uart_tx_used(p_bulk) > 0) {
+            m_tx_bulk_left = uart_tx_get(p_bulk);
+            continue;
+        }
+        else {
+            return;
+        }
+
+        uint8_t byte = p_lane->p_buf[p_lane->read & (p_lane->size - 1)];
+        if (app_uart_put(byte) != NRF_SUCCESS) {
+            return;
+        }
+        ++p_lane->read;
+        if (p_lane == p_bulk) {
+            --m_tx_bulk_left;
+        }
+    }
+}
+
+static void uart_event_handler(app_uart_evt_t * p_event)
+{
+    uint8_t data;
+
+    switch (p_event->evt_type)
+    {
+        case APP_UART_DATA_READY:
+            if (app_uart_get(&data) == NRF_SUCCESS && m_rx_handler != NULL) {
+                m_rx_handler(data);
+            }
+            break;
+        case APP_UART_TX_EMPTY:
+            CRITICAL_REGION_ENTER();
+            uart_tx_pump();
+            CRITICAL_REGION_EXIT();
+            break;
+        case APP_UART_COMMUNICATION_ERROR:
+            APP_ERROR_HANDLER(p_event->data.error_communication);
+            break;
+        case APP_UART_FIFO_ERROR:
+            APP_ERROR_HANDLER(p_event->data.error_code);
+            break;
+        default:
+            break;
+    }
+}
+
+void uart_init(uart_rx_handler_t rx_handler)
+{
+    uint32_t err_code;
+
+    m_rx_handler = rx_handler;
+
+    const app_uart_comm_params_t comm_params =
+      {
+        .rx_pin_no    = RX_PIN_NUMBER,
+        .tx_pin_no    = TX_PIN_NUMBER,
+        .rts_pin_no   = RTS_PIN_NUMBER,
+        .cts_pin_no   = CTS_PIN_NUMBER,
+        .flow_control = APP_UART_FLOW_CONTROL_ENABLED,
+        .use_parity   = false,
+        .baud_rate    = UART_BAUD_REGISTER
+      };
+
+    // As on the nRF52: the lowest application priority, shared with the BLE and app_timer
+    // events. Received lines run commands that call the SoftDevice, which is not allowed from
+    // APP_IRQ_PRIORITY_MID (app high on the nRF51), and that touch state those handlers own.
+    APP_UART_FIFO_INIT(&comm_params,
+                        UART_RX_BUF_SIZE,
+                        UART_TX_BUF_SIZE,
+                        uart_event_handler,
+                        APP_IRQ_PRIORITY_LOWEST,
+                        err_code);
+
+    APP_ERROR_CHECK(err_code);
+}
+
+uint16_t uart_write(uart_lane_t lane, const uint8_t * p_data, uint16_t len)
+{
+    uart_tx_lane_t * p_lane = &m_tx_lanes[lane];
+    uint16_t written = 0;
+
+    // Writes come from thread mode and the application interrupts, the pump also runs from
+    // the UART interrupt
+    CRITICAL_REGION_ENTER();
+    uint16_t free = p_lane->size - uart_tx_used(p_lane);
+    if (lane == UART_LANE_BULK) {
+        // Queued behind its length, so a bulk write is cut to UINT8_MAX bytes
+        uint8_t length = (uint8_t)MIN(len, UINT8_MAX);
+        if (length + 1 <= free) {
+            uart_tx_put(p_lane, &length, 1);
+            written = length;
+        }
+    }
+    else if (len <= free || len > p_lane->size) {
+        written = MIN(len, free);
+    }
+    uart_tx_put(p_lane, p_data, written);
+    uart_tx_pump();
+    p_lane->peak = MAX(p_lane->peak, uart_tx_used(p_lane) * 100 / p_lane->size);
+    p_lane->dropped += len - written;
+    CRITICAL_REGION_EXIT();
+
+    if (written < len) {
+        stats_add(STATS_UART_DROPPED, len - written);
+    }
+    return written;
+}
+
+uint16_t uart_free(uart_lane_t lane)
+{
+    uint16_t free;
+
+    CRITICAL_REGION_ENTER();
+    free = m_tx_lanes[lane].size - uart_tx_used(&m_tx_lanes[lane]);
+    CRITICAL_REGION_EXIT();
+    if (lane == UART_LANE_BULK) {
+        // Less the length byte in front of the write
+        free = (free > 0) ? MIN(free - 1, UINT8_MAX) : 0;
+    }
+    return free;
+}
+
+#endif // NRF52
+
+uint8_t uart_peak(uart_lane_t lane)
+{
+    uint8_t peak;
+
+    CRITICAL_REGION_ENTER();
+    peak = m_tx_lanes[lane].peak;
+    m_tx_lanes[lane].peak = 0;
+    CRITICAL_REGION_EXIT();
+    return peak;
+}
+
+uint32_t uart_dropped(uart_lane_t lane)
+{
+    uint32_t dropped;
+
+    CRITICAL_REGION_ENTER();
+    dropped = m_tx_lanes[lane].dropped;
+    CRITICAL_REGION_EXIT();
+    return dropped;
+}
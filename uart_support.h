@@ -0,0 +1,93 @@
+/* MIT License
+ *
+ * Copyright (c) 2025 Matthew Nathan Green
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, andor sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ */
+
+#ifndef UART_SUPPORT_H
+#define UART_SUPPORT_H
+
+/**@file
+ *
+ * @brief    UART transport for the output stream, diagnostics and commands.
+ *
+ * @details  Output is queued in two lanes with separate buffers. Whenever the line is free to
+ *           take more, the urgent lane is served first, so an alert or a link event never waits
+ *           behind more than the bulk record already being sent. The lanes only take turns
+ *           between writes: each write is queued whole or dropped whole, so a record is never
+ *           split by a record from the other lane.
+ *
+ *           On the nRF51 the UART is driven by app_uart_fifo, one byte per interrupt. Its FIFO is
+ *           kept short and is topped up from the lanes each time it runs empty.
+ *
+ *           On the nRF52 UARTE0 is driven directly with EasyDMA. Each lane copies output into one
+ *           of two blocks while the other may be being sent, and a filled block is handed to the
+ *           DMA when the transfer in flight ends, so there is one interrupt per block instead of
+ *           one per byte. Received bytes are taken one at a time into a pair of one byte DMA
+ *           buffers; command traffic is light.
+ *
+ *           Bytes that do not fit are dropped and counted in STATS_UART_DROPPED, and per lane
+ *           for uart_dropped. Output that can wait, such as a counter table, checks uart_free
+ *           first and is written as the lane drains.
+ */
+
+#include <stdint.h>
+
+#ifndef UART_BAUD
+#define UART_BAUD               115200                          /**< 115200, 230400, 460800, 921600 or 1000000: make UART_BAUD=1000000 */
+#endif
+
+/**@brief Output lanes, in the order they are served. */
+typedef enum
+{
+    UART_LANE_URGENT,                       // Alerts, link events, command replies
+    UART_LANE_BULK,                         // Sensor samples and counter tables
+    UART_LANE_COUNT
+} uart_lane_t;
+
+/**@brief   Called for each byte received, from the UART interrupt. */
+typedef void (* uart_rx_handler_t)(uint8_t byte);
+
+
+/**@brief Function for initializing the UART.
+ *
+ * @param[in] rx_handler        event loop function to handle received bytes 
+ */
+void uart_init(uart_rx_handler_t rx_handler);
+
+/**@brief   Queue bytes for transmission without blocking.
+ *
+ * @details A write that does not fit in its lane is dropped whole, unless it is longer than
+ *          the lane can ever hold; such a write is queued as far as it fits.
+ *
+ * @param[in] lane      Lane to queue the bytes in
+ * @param[in] p_data    Bytes to send
+ * @param[in] len       Number of bytes
+ *
+ * @return  Number of bytes queued; the rest were dropped.
+ */
+uint16_t uart_write(uart_lane_t lane, const uint8_t * p_data, uint16_t len);
+
+/**@brief   Highest fill of a lane since the previous call, in percent of what it can queue.
+ *
+ * @details Measured after each write, once the bytes that could be sent straight away are
+ *          gone. At 100 the next write is dropped.
+ */
+uint8_t uart_peak(uart_lane_t lane);
+
+/**@brief   Longest write the lane takes now without dropping it. */
+uint16_t uart_free(uart_lane_t lane);
+
+/**@brief   Bytes dropped from the lane since boot; wraps. */
+uint32_t uart_dropped(uart_lane_t lane);
+
+#endif // UART_SUPPORT_H